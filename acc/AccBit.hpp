@@ -52,6 +52,9 @@ namespace acc
     using std::bit_floor;
     using std::bit_width;
     using std::countl_zero;
+    using std::countr_zero;
+    using std::popcount;
+    using std::has_single_bit;
 }
 #else
 
@@ -96,6 +99,70 @@ template<class T> constexpr T countl_zero(T x) noexcept
     }
 }
 
+// Without the GCC builtins, countr_zero and popcount fall back to plain
+// constexpr loops.
+
+template<class T> constexpr int countr_zero(T x) noexcept
+{
+    constexpr auto Nd = std::numeric_limits<T>::digits;
+
+    if (x == 0) return Nd;
+
+#if defined(__GNUC__)
+    constexpr auto Nd_ull = std::numeric_limits<unsigned long long>::digits;
+    constexpr auto Nd_ul = std::numeric_limits<unsigned long>::digits;
+    constexpr auto Nd_u = std::numeric_limits<unsigned>::digits;
+
+    if constexpr (Nd <= Nd_u) return __builtin_ctz(x);
+    else if constexpr (Nd <= Nd_ul) return __builtin_ctzl(x);
+    else if constexpr (Nd <= Nd_ull) return __builtin_ctzll(x);
+    else {
+        static_assert(Nd <= (2 * Nd_ull),
+            "Maximum supported integer size is 128-bit");
+        constexpr auto max_ull = std::numeric_limits<unsigned long long>::max();
+        unsigned long long low = x & max_ull;
+        if (low != 0) return __builtin_ctzll(low);
+        unsigned long long high = x >> Nd_ull;
+        return __builtin_ctzll(high) + Nd_ull;
+    }
+#else
+    int n = 0;
+    while (!(x & 1)) x >>= 1, ++n;
+    return n;
+#endif
+}
+
+template<class T> constexpr int popcount(T x) noexcept
+{
+#if defined(__GNUC__)
+    constexpr auto Nd = std::numeric_limits<T>::digits;
+    constexpr auto Nd_ull = std::numeric_limits<unsigned long long>::digits;
+    constexpr auto Nd_ul = std::numeric_limits<unsigned long>::digits;
+    constexpr auto Nd_u = std::numeric_limits<unsigned>::digits;
+
+    if constexpr (Nd <= Nd_u) return __builtin_popcount(x);
+    else if constexpr (Nd <= Nd_ul) return __builtin_popcountl(x);
+    else if constexpr (Nd <= Nd_ull) return __builtin_popcountll(x);
+    else {
+        static_assert(Nd <= (2 * Nd_ull),
+            "Maximum supported integer size is 128-bit");
+        constexpr auto max_ull = std::numeric_limits<unsigned long long>::max();
+        unsigned long long low = x & max_ull;
+        unsigned long long high = x >> Nd_ull;
+        return __builtin_popcountll(low) + __builtin_popcountll(high);
+    }
+#else
+    int n = 0;
+    for (; x != 0; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+template<class T> constexpr bool has_single_bit(T x) noexcept
+{
+    return x != 0 && (x & (x - 1)) == 0;
+}
+
 template<class T> constexpr T bit_width(T x) noexcept
 {
     return std::numeric_limits<T>::digits - acc::countl_zero(x);
@@ -0,0 +1,238 @@
+// A deque that keeps the aggregate of its elements under a monoid.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+#include "Deque.hpp"
+#include "Span.hpp"
+#include "IndexingIterator.hpp"
+
+#ifndef _ACC_AGGREGATING_DEQUE
+#define _ACC_AGGREGATING_DEQUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// A monoid has an identity and an associative operation, which need not be
+// commutative: op(a, b) combines `a` with `b` that comes after it.
+//
+//     T identity() const;
+//     T operator()(const T& a, const T& b) const;
+
+template<typename T>
+struct SumMonoid
+{
+    T identity() const { return T(); }
+    T operator()(const T& a, const T& b) const { return a + b; }
+};
+
+template<typename T>
+struct MinMonoid
+{
+    T identity() const
+    {
+        return std::numeric_limits<T>::has_infinity
+            ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    }
+    T operator()(const T& a, const T& b) const { return b < a ? b : a; }
+};
+
+template<typename T>
+struct MaxMonoid
+{
+    T identity() const
+    {
+        return std::numeric_limits<T>::has_infinity
+            ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+    }
+    T operator()(const T& a, const T& b) const { return a < b ? b : a; }
+};
+
+// An acc::Deque whose elements carry the aggregate of their block from the
+// seam outwards: an element of the back block holds the aggregate of the
+// back block up to it, one of the front block that of the front block from
+// it to the seam. The front element of the front block and the back element
+// of the back block hold the aggregates of the two blocks, so query(), the
+// aggregate of the whole deque, is one operation. This is the two-stack
+// queue of sliding-window aggregation, with pushes and pops at both ends.
+//
+// A push computes the aggregate of the new element with one operation. A
+// pop from an empty block rebuilds like acc::Deque, and the aggregates of
+// both blocks are computed again, in time linear in the rebuilt size; so
+// every operation is amortized O(1) operations of the monoid. The default
+// QueueRebuild moves the whole back block on a rebuild, right for a window
+// (push_back and pop_front); use HalfRebuild when both ends pop.
+//
+// Elements are read-only: changing one would change aggregates.
+template<typename T, typename Monoid = SumMonoid<T>, typename RebuildPolicy = QueueRebuild>
+class AggregatingDeque : private Monoid
+{
+
+private:
+
+    typedef AggregatingDeque<T, Monoid, RebuildPolicy> Self;
+
+    struct Node
+    {
+        T value;
+        T agg;
+    };
+
+public:
+
+    DERIVE_ACC_INDEXING_ITERATOR(_Iterator, at_unsafe)
+
+    typedef T                                           value_type;
+    typedef Monoid                                      monoid_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef const T&                                    reference;
+    typedef const T&                                    const_reference;
+    typedef const T*                                    pointer;
+    typedef const T*                                    const_pointer;
+    typedef _Iterator<const T&, const T*>               iterator;
+    typedef iterator                                    const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef reverse_iterator                            const_reverse_iterator;
+
+    explicit AggregatingDeque(const Monoid& monoid = Monoid()): Monoid(monoid) { }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    AggregatingDeque(InputIt first, InputIt last, const Monoid& monoid = Monoid())
+        : Monoid(monoid)
+    {
+        for (; first != last; ++first) push_back(*first);
+    }
+    AggregatingDeque(std::initializer_list<value_type> init, const Monoid& monoid = Monoid())
+        : AggregatingDeque(init.begin(), init.end(), monoid) { }
+
+    // The aggregate of all elements from front to back, the identity when
+    // the deque is empty.
+    value_type query() const
+    {
+        Span<const Node> f = dq.reversed_front_span(), b = dq.back_span();
+        if (f.empty()) return b.empty() ? monoid().identity() : b[b.size() - 1].agg;
+        if (b.empty()) return f[f.size() - 1].agg;
+        return monoid()(f[f.size() - 1].agg, b[b.size() - 1].agg);
+    }
+
+    const_reference operator[](size_type pos) const { return dq[pos].value; }
+    const_reference at(size_type pos) const { return dq.at(pos).value; }
+    const_reference front() const { return dq.front().value; }
+    const_reference back() const { return dq.back().value; }
+
+    const_iterator begin() const { return const_iterator(0, this); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const { return const_iterator(difference_type(size()), this); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    size_type size() const { return dq.size(); }
+    bool empty() const { return dq.empty(); }
+
+    void push_back(const value_type& val)
+    {
+        Span<Node> b = dq.back_span();
+        dq.push_back(Node{val, b.empty() ? val : monoid()(b[b.size() - 1].agg, val)});
+    }
+
+    void push_front(const value_type& val)
+    {
+        Span<Node> f = dq.reversed_front_span();
+        dq.push_front(Node{val, f.empty() ? val : monoid()(val, f[f.size() - 1].agg)});
+    }
+
+    void pop_front()
+    {
+        bool rebuilds = dq.reversed_front_span().empty();
+        dq.pop_front();
+        if (rebuilds) reaggregate();
+    }
+
+    void pop_back()
+    {
+        bool rebuilds = dq.back_span().empty();
+        dq.pop_back();
+        if (rebuilds) reaggregate();
+    }
+
+    void clear() { dq.clear(); }
+
+    void shrink_to_fit() { dq.shrink_to_fit(); }
+
+    const Monoid& monoid() const noexcept { return *this; }
+
+    void swap(Self& other)
+    {
+        using std::swap;
+        swap(static_cast<Monoid&>(*this), static_cast<Monoid&>(other));
+        dq.swap(other.dq);
+    }
+
+private:
+
+    Deque<Node, std::vector<Node>, RebuildPolicy> dq;
+
+    const_pointer at_unsafe(difference_type pos) const
+    {
+        return &dq[size_type(pos)].value;
+    }
+
+    // After a rebuild: both blocks changed, so their aggregates are computed
+    // again from the seam outwards.
+    void reaggregate()
+    {
+        const Monoid& op = monoid();
+        Span<Node> f = dq.reversed_front_span(), b = dq.back_span();
+        for (size_type i = 0; i < f.size(); ++i) {
+            f[i].agg = i == 0 ? f[i].value : op(f[i].value, f[i - 1].agg);
+        }
+        for (size_type i = 0; i < b.size(); ++i) {
+            b[i].agg = i == 0 ? b[i].value : op(b[i - 1].agg, b[i].value);
+        }
+    }
+
+};
+
+template<typename T, typename Monoid, typename RebuildPolicy>
+void swap(AggregatingDeque<T, Monoid, RebuildPolicy>& lhs,
+          AggregatingDeque<T, Monoid, RebuildPolicy>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::AggregatingDeque.");
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,435 @@
+// Arena and pool memory resources, and allocators on top of them.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define _ACC_HAS_PMR
+#endif
+#endif
+
+#include "AccBit.hpp"
+
+#ifndef _ACC_ALLOCATOR
+#define _ACC_ALLOCATOR
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// A memory resource has
+//     void* allocate(std::size_t bytes, std::size_t align);
+//     void deallocate(void* p, std::size_t bytes, std::size_t align);
+// like std::pmr::memory_resource, but without virtual calls. Resources are
+// neither copyable nor movable; allocators refer to them by pointer.
+
+// The global operator new and delete.
+class NewDeleteResource
+{
+public:
+
+    void* allocate(std::size_t bytes, std::size_t align)
+    {
+#ifdef __cpp_aligned_new
+        if (align > alignof(std::max_align_t)) {
+            return ::operator new(bytes, std::align_val_t(align));
+        }
+#endif
+        if (align > alignof(std::max_align_t)) throw std::bad_alloc();
+        return ::operator new(bytes);
+    }
+
+    void deallocate(void* p, std::size_t, std::size_t align) noexcept
+    {
+#ifdef __cpp_aligned_new
+        if (align > alignof(std::max_align_t)) {
+            ::operator delete(p, std::align_val_t(align));
+            return;
+        }
+#endif
+        (void)align;
+        ::operator delete(p);
+    }
+
+};
+
+inline NewDeleteResource* new_delete_resource() noexcept
+{
+    static NewDeleteResource res;
+    return &res;
+}
+
+// Hands out memory by bumping a pointer through chunks that double in size.
+// deallocate() does nothing, except that the most recent allocation can be
+// given back, which lets a vector that grows last reuse its own space.
+// Everything is freed at once by release() or the destructor, so the
+// containers using the arena must be destroyed (or simply dropped, for
+// trivially destructible elements) before that.
+class MonotonicArena
+{
+public:
+
+    explicit MonotonicArena(std::size_t initial_size = 4096)
+        : first_size(initial_size < 64 ? 64 : initial_size), next_size(first_size) { }
+
+    // Starts with a buffer owned by the caller, e.g. on the stack.
+    MonotonicArena(void* buffer, std::size_t size)
+        : cur(static_cast<char*>(buffer)), end(cur + size),
+          initial(cur), initial_end(end), first_size(size < 64 ? 64 : 2 * size),
+          next_size(first_size) { }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() { free_chunks(); }
+
+    void* allocate(std::size_t bytes, std::size_t align)
+    {
+        char* p = align_up(cur, align);
+        if (p == nullptr || p > end || std::size_t(end - p) < bytes) {
+            new_chunk(bytes + align);
+            p = align_up(cur, align);
+        }
+        cur = p + bytes;
+        return p;
+    }
+
+    void deallocate(void* p, std::size_t bytes, std::size_t) noexcept
+    {
+        if (static_cast<char*>(p) + bytes == cur) cur = static_cast<char*>(p);
+    }
+
+    // Frees every chunk and starts over with the caller's buffer, if any.
+    void release() noexcept
+    {
+        free_chunks();
+        cur = initial, end = initial_end;
+        next_size = first_size;
+    }
+
+    // Bytes currently held from the global operator new.
+    std::size_t upstream_bytes() const noexcept { return total; }
+
+private:
+
+    struct Chunk
+    {
+        Chunk* next;
+        std::size_t size;
+    };
+
+    char* cur = nullptr;
+    char* end = nullptr;
+    char* initial = nullptr;
+    char* initial_end = nullptr;
+    Chunk* chunks = nullptr;
+    std::size_t first_size;
+    std::size_t next_size;
+    std::size_t total = 0;
+
+    static char* align_up(char* p, std::size_t align) noexcept
+    {
+        std::uintptr_t x = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<char*>((x + align - 1) & ~std::uintptr_t(align - 1));
+    }
+
+    void new_chunk(std::size_t least)
+    {
+        std::size_t size = next_size;
+        while (size < least + sizeof(Chunk)) size *= 2;
+        Chunk* c = static_cast<Chunk*>(::operator new(size));
+        c->next = chunks, c->size = size;
+        chunks = c;
+        total += size;
+        next_size = 2 * size;
+        cur = reinterpret_cast<char*>(c + 1);
+        end = reinterpret_cast<char*>(c) + size;
+    }
+
+    void free_chunks() noexcept
+    {
+        while (chunks) {
+            Chunk* c = chunks;
+            chunks = c->next;
+            ::operator delete(c);
+        }
+        total = 0;
+    }
+
+};
+
+// Keeps a free list per power-of-two size class from 16 bytes to
+// `max_block` bytes. A freed block goes back to its list and the next
+// allocation of that class takes it, so the buffers a growing vector or a
+// Deque rebuild gives up are recycled. Lists are refilled with chunks of
+// several blocks from the global operator new; larger or over-aligned
+// requests go straight to it. release() and the destructor free the chunks.
+class Pool
+{
+public:
+
+    static constexpr std::size_t min_block = 16;
+
+    explicit Pool(std::size_t max_block = 65536)
+        : classes(class_of(max_block < min_block ? std::size_t(min_block) : max_block) + 1)
+    {
+        if (classes > max_classes) classes = max_classes;
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    ~Pool() { release(); }
+
+    void* allocate(std::size_t bytes, std::size_t align)
+    {
+        std::size_t k = class_of(bytes);
+        if (k >= classes || align > alignof(std::max_align_t)) {
+            return new_delete_resource()->allocate(bytes, align);
+        }
+        Block* b = lists[k];
+        if (b == nullptr) b = refill(k);
+        lists[k] = b->next;
+        return b;
+    }
+
+    void deallocate(void* p, std::size_t bytes, std::size_t align) noexcept
+    {
+        std::size_t k = class_of(bytes);
+        if (k >= classes || align > alignof(std::max_align_t)) {
+            new_delete_resource()->deallocate(p, bytes, align);
+            return;
+        }
+        Block* b = static_cast<Block*>(p);
+        b->next = lists[k];
+        lists[k] = b;
+    }
+
+    // Frees every chunk; blocks still in use become invalid.
+    void release() noexcept
+    {
+        while (chunks) {
+            Chunk* c = chunks;
+            chunks = c->next;
+            ::operator delete(c);
+        }
+        for (Block*& b: lists) b = nullptr;
+    }
+
+private:
+
+    struct Block { Block* next; };
+
+    struct alignas(std::max_align_t) Chunk { Chunk* next; };
+
+    static constexpr std::size_t max_classes = 48;
+    static constexpr std::size_t chunk_bytes = 65536;
+
+    std::size_t classes;
+    Block* lists[max_classes] = {};
+    Chunk* chunks = nullptr;
+
+    // Class k holds blocks of min_block << k bytes.
+    static std::size_t class_of(std::size_t bytes) noexcept
+    {
+        if (bytes <= min_block) return 0;
+        return std::size_t(acc::bit_width(bytes - 1)) - 4;
+    }
+
+    Block* refill(std::size_t k)
+    {
+        std::size_t size = min_block << k;
+        std::size_t count = chunk_bytes / size < 4 ? 4 : chunk_bytes / size;
+        Chunk* c = static_cast<Chunk*>(::operator new(sizeof(Chunk) + count * size));
+        c->next = chunks;
+        chunks = c;
+        char* p = reinterpret_cast<char*>(c + 1);
+        for (std::size_t i = count; i-- > 0; ) {
+            Block* b = reinterpret_cast<Block*>(p + i * size);
+            b->next = lists[k];
+            lists[k] = b;
+        }
+        return lists[k];
+    }
+
+};
+
+// An allocator that takes its memory from a resource. Copies (and rebound
+// copies) share the resource and compare equal exactly when they use the
+// same one. The allocator follows the containers on assignment and swap, so
+// a container swapped or moved between resources stays correct. Default
+// constructed (as Deque's move constructor does) it has no resource and
+// uses the global operator new.
+template<typename T, typename Resource>
+class ResourceAllocator
+{
+public:
+
+    typedef T           value_type;
+    typedef Resource    resource_type;
+
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template<typename U> struct rebind { typedef ResourceAllocator<U, Resource> other; };
+
+    ResourceAllocator() noexcept: res(nullptr) { }
+    ResourceAllocator(Resource* r) noexcept: res(r) { }
+    template<typename U>
+    ResourceAllocator(const ResourceAllocator<U, Resource>& o) noexcept: res(o.resource()) { }
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::size_t(-1) / sizeof(T)) throw std::bad_alloc();
+        if (res == nullptr) {
+            return static_cast<T*>(new_delete_resource()->allocate(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(res->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        if (res == nullptr) new_delete_resource()->deallocate(p, n * sizeof(T), alignof(T));
+        else res->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    Resource* resource() const noexcept { return res; }
+
+private:
+
+    Resource* res;
+
+};
+
+template<typename T, typename U, typename R>
+bool operator==(const ResourceAllocator<T, R>& a, const ResourceAllocator<U, R>& b) noexcept
+{
+    return a.resource() == b.resource();
+}
+
+template<typename T, typename U, typename R>
+bool operator!=(const ResourceAllocator<T, R>& a, const ResourceAllocator<U, R>& b) noexcept
+{
+    return !(a == b);
+}
+
+template<typename T>
+using ArenaAllocator = ResourceAllocator<T, MonotonicArena>;
+
+template<typename T>
+using PoolAllocator = ResourceAllocator<T, Pool>;
+
+// Allocates from the global operator new at `Align` bytes, a cache line by
+// default, so a container's element k lies at a known offset in its line.
+// Before C++17 there is no aligned new, and it gets the alignment of
+// std::max_align_t instead.
+template<typename T, std::size_t Align = 64>
+class CacheAlignedAllocator
+{
+public:
+
+    typedef T value_type;
+
+#ifdef __cpp_aligned_new
+    static constexpr std::size_t alignment = Align < alignof(T) ? alignof(T) : Align;
+#else
+    static constexpr std::size_t alignment = alignof(std::max_align_t);
+#endif
+
+    template<typename U> struct rebind { typedef CacheAlignedAllocator<U, Align> other; };
+
+    CacheAlignedAllocator() noexcept { }
+    template<typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U, Align>&) noexcept { }
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::size_t(-1) / sizeof(T)) throw std::bad_alloc();
+        return static_cast<T*>(new_delete_resource()->allocate(n * sizeof(T), alignment));
+    }
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        new_delete_resource()->deallocate(p, n * sizeof(T), alignment);
+    }
+
+};
+
+template<typename T, typename U, std::size_t A>
+bool operator==(const CacheAlignedAllocator<T, A>&, const CacheAlignedAllocator<U, A>&) noexcept
+{
+    return true;
+}
+
+template<typename T, typename U, std::size_t A>
+bool operator!=(const CacheAlignedAllocator<T, A>&, const CacheAlignedAllocator<U, A>&) noexcept
+{
+    return false;
+}
+
+#ifdef _ACC_HAS_PMR
+
+// Exposes an acc resource as a std::pmr::memory_resource, for the std::pmr
+// containers. The other way round, ResourceAllocator<T,
+// std::pmr::memory_resource> takes its memory from any pmr resource.
+template<typename Resource>
+class PmrResource : public std::pmr::memory_resource
+{
+public:
+
+    explicit PmrResource(Resource* r) noexcept: res(r) { }
+
+    Resource* resource() const noexcept { return res; }
+
+private:
+
+    Resource* res;
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        return res->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override
+    {
+        res->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        const PmrResource* o = dynamic_cast<const PmrResource*>(&other);
+        return o != nullptr && o->res == res;
+    }
+
+};
+
+#endif
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::Allocator.");
+
+#endif
+
+}
+
+#endif
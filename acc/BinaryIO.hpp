@@ -0,0 +1,478 @@
+// Binary files of acc::Deque and acc::Vector, and a view that maps them.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "Deque.hpp"
+#include "Vector.hpp"
+#include "Span.hpp"
+#include "IndexingIterator.hpp"
+
+#ifndef _ACC_BINARY_IO
+#define _ACC_BINARY_IO
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// A file holds the elements of one container of trivially copyable T as they
+// are laid out in memory, after a 64-byte header:
+//
+//     [header][padding to data_offset][front: `front` elements][back]
+//
+// The front piece is the front block of an acc::Deque, stored reversed like
+// in the deque, so it is written straight from memory. Element i of the
+// sequence is front[front - 1 - i] when i < front, back[i - front] otherwise.
+// A Vector has no front piece. data_offset is a multiple of alignof(T) and
+// the header is at the start of a page once mapped, so the mapped elements
+// are aligned.
+//
+// Files are only read on machines with the same byte order and element size
+// as the writer; anything else is rejected rather than converted.
+struct BinaryHeader
+{
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t value_size;
+    std::uint64_t value_align;
+    std::uint64_t front;
+    std::uint64_t size;
+    std::uint64_t data_offset;
+    std::uint64_t reserved;
+};
+
+static_assert(sizeof(BinaryHeader) == 64, "BinaryHeader must be 64 bytes.");
+
+namespace binary_io
+{
+
+constexpr char magic[8] = {'a', 'c', 'c', 'b', 'i', 'n', '\0', '\0'};
+
+template<typename T>
+constexpr std::uint64_t data_offset()
+{
+    return (sizeof(BinaryHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+template<typename T>
+BinaryHeader make_header(std::size_t front, std::size_t size)
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+        "Binary files hold trivially copyable elements only.");
+    BinaryHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, magic, sizeof(magic));
+    h.version = BinaryHeader::current_version;
+    h.byte_order = BinaryHeader::byte_order_mark;
+    h.value_size = sizeof(T);
+    h.value_align = alignof(T);
+    h.front = front;
+    h.size = size;
+    h.data_offset = data_offset<T>();
+    return h;
+}
+
+// Throws std::runtime_error unless `h` describes a file of T of at most
+// `file_size` bytes (ignored when 0).
+template<typename T>
+void check_header(const BinaryHeader& h, std::uint64_t file_size, const char* who)
+{
+    auto fail = [who](const char* what) {
+        throw std::runtime_error(std::string(who) + ": " + what);
+    };
+    if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) fail("not an acc binary file");
+    if (h.version != BinaryHeader::current_version) fail("unsupported version");
+    if (h.byte_order != BinaryHeader::byte_order_mark) fail("byte order differs");
+    if (h.value_size != sizeof(T) || h.value_align != alignof(T)) {
+        fail("element type differs");
+    }
+    if (h.front > h.size || h.data_offset != data_offset<T>()) fail("corrupt header");
+    if (h.size > (UINT64_MAX - h.data_offset) / sizeof(T)) fail("corrupt header");
+    if (file_size != 0 && file_size < h.data_offset + h.size * sizeof(T)) fail("truncated");
+}
+
+[[noreturn]] inline void throw_errno(const char* who)
+{
+    throw std::system_error(errno, std::generic_category(), who);
+}
+
+// Writes all of iov[0, count). A single call may write less than asked, and
+// Linux caps one call at about 2 GB, so it continues from where it stopped.
+inline void write_all(int fd, struct iovec* iov, std::size_t count, const char* who)
+{
+    while (count > 0) {
+        if (iov->iov_len == 0) {
+            ++iov, --count;
+            continue;
+        }
+        ssize_t n = ::writev(fd, iov, int(std::min<std::size_t>(count, IOV_MAX)));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw_errno(who);
+        }
+        std::size_t done = std::size_t(n);
+        while (count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov, --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+}
+
+inline void read_all(int fd, void* buf, std::size_t len, const char* who)
+{
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        ssize_t n = ::read(fd, p, std::min<std::size_t>(len, SSIZE_MAX));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw_errno(who);
+        }
+        if (n == 0) throw std::runtime_error(std::string(who) + ": truncated");
+        p += n, len -= std::size_t(n);
+    }
+}
+
+// Reads a header of T and skips to the elements.
+template<typename T>
+BinaryHeader read_header(int fd, const char* who)
+{
+    BinaryHeader h;
+    read_all(fd, &h, sizeof(h), who);
+    check_header<T>(h, 0, who);
+    char pad[alignof(T) > sizeof(BinaryHeader) ? alignof(T) : 1];
+    read_all(fd, pad, std::size_t(h.data_offset - sizeof(h)), who);
+    return h;
+}
+
+inline struct iovec piece(const void* p, std::size_t bytes)
+{
+    struct iovec v;
+    v.iov_base = const_cast<void*>(p);
+    v.iov_len = bytes;
+    return v;
+}
+
+// Opens `path` and closes it when it goes out of scope.
+class File
+{
+
+public:
+
+    File(const std::string& path, int flags, const char* who)
+        : fd(::open(path.c_str(), flags | O_CLOEXEC, 0644))
+    {
+        if (fd < 0) throw_errno(who);
+    }
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+    ~File() { if (fd >= 0) ::close(fd); }
+
+    int get() const { return fd; }
+
+    // Closes now, so that a failing close (e.g. a full NFS disk) is reported.
+    void close(const char* who)
+    {
+        int res = ::close(fd);
+        fd = -1;
+        if (res != 0) throw_errno(who);
+    }
+
+private:
+
+    int fd;
+
+};
+
+}
+
+// Writes `x` to the file descriptor `fd` at its current offset: one writev
+// of the header and the two blocks, from memory, without formatting.
+template<typename T, typename Container, typename RebuildPolicy>
+void write_binary(int fd, const Deque<T, Container, RebuildPolicy>& x)
+{
+    Span<const T> f = x.reversed_front_span(), b = x.back_span();
+    BinaryHeader h = binary_io::make_header<T>(f.size(), x.size());
+    char pad[alignof(T) > sizeof(BinaryHeader) ? alignof(T) : 1] = { };
+    struct iovec iov[4] = {
+        binary_io::piece(&h, sizeof(h)),
+        binary_io::piece(pad, std::size_t(h.data_offset - sizeof(h))),
+        binary_io::piece(f.data(), f.size() * sizeof(T)),
+        binary_io::piece(b.data(), b.size() * sizeof(T))
+    };
+    binary_io::write_all(fd, iov, 4, "acc::write_binary");
+}
+
+// Writes `x` to `fd` with one writev over its blocks.
+template<typename T, typename Alloc>
+void write_binary(int fd, const Vector<T, Alloc>& x)
+{
+    BinaryHeader h = binary_io::make_header<T>(0, x.size());
+    char pad[alignof(T) > sizeof(BinaryHeader) ? alignof(T) : 1] = { };
+    std::vector<struct iovec> iov;
+    iov.push_back(binary_io::piece(&h, sizeof(h)));
+    iov.push_back(binary_io::piece(pad, std::size_t(h.data_offset - sizeof(h))));
+    x.for_each_segment([&iov](const T* p, std::size_t n) {
+        iov.push_back(binary_io::piece(p, n * sizeof(T)));
+    });
+    binary_io::write_all(fd, iov.data(), iov.size(), "acc::write_binary");
+}
+
+// Replaces the contents of `x` with the container read from `fd`. The
+// elements are read straight into the back block; only the front piece is
+// reversed in place afterwards. Throws std::runtime_error when the file does
+// not hold elements of T, std::system_error when reading fails.
+template<typename T, typename Container, typename RebuildPolicy>
+void read_binary(int fd, Deque<T, Container, RebuildPolicy>& x)
+{
+    const char* who = "acc::read_binary";
+    BinaryHeader h = binary_io::read_header<T>(fd, who);
+    x.clear();
+    x.resize(std::size_t(h.size));
+    T* p = x.back_span().data();
+    binary_io::read_all(fd, p, std::size_t(h.size) * sizeof(T), who);
+    std::reverse(p, p + h.front);
+}
+
+template<typename T, typename Alloc>
+void read_binary(int fd, Vector<T, Alloc>& x)
+{
+    const char* who = "acc::read_binary";
+    BinaryHeader h = binary_io::read_header<T>(fd, who);
+    x.clear();
+    x.resize(std::size_t(h.size));
+    x.for_each_segment([fd, who](T* p, std::size_t n) {
+        binary_io::read_all(fd, p, n * sizeof(T), who);
+    });
+}
+
+// Creates or truncates the file at `path` and writes `x` to it. To replace
+// a checkpoint atomically, save to a temporary name and rename it.
+template<typename Container>
+void save_binary(const std::string& path, const Container& x)
+{
+    binary_io::File file(path, O_WRONLY | O_CREAT | O_TRUNC, "acc::save_binary");
+    write_binary(file.get(), x);
+    file.close("acc::save_binary");
+}
+
+template<typename Container>
+void load_binary(const std::string& path, Container& x)
+{
+    binary_io::File file(path, O_RDONLY, "acc::load_binary");
+    read_binary(file.get(), x);
+}
+
+// A read-only view of a file written by write_binary, mapped into memory.
+// Opening it reads the header only: pages are loaded by the kernel when
+// touched, so opening a file of any size takes constant time. The elements
+// stay where the file is mapped, with the random access and iterators of a
+// const acc::Deque.
+//
+// The file must not be truncated while it is mapped. Writes to it through
+// other descriptors may or may not show through the view.
+template<typename T>
+class MappedDequeView
+{
+
+private:
+
+    typedef MappedDequeView<T> Self;
+
+public:
+
+    DERIVE_ACC_INDEXING_ITERATOR(_Iterator, at_unsafe)
+
+    typedef T                                           value_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef const T&                                    reference;
+    typedef const T&                                    const_reference;
+    typedef const T*                                    pointer;
+    typedef const T*                                    const_pointer;
+    typedef _Iterator<const T&, const T*>               iterator;
+    typedef iterator                                    const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef reverse_iterator                            const_reverse_iterator;
+
+    static_assert(std::is_trivially_copyable<T>::value,
+        "MappedDequeView holds trivially copyable elements only.");
+
+    MappedDequeView() noexcept: map(nullptr), map_len(0), pre(nullptr), suf(nullptr),
+        pre_len(0), suf_len(0) { }
+
+    explicit MappedDequeView(const std::string& path): MappedDequeView()
+    {
+        const char* who = "acc::MappedDequeView";
+        binary_io::File file(path, O_RDONLY, who);
+        struct stat st;
+        if (::fstat(file.get(), &st) != 0) binary_io::throw_errno(who);
+        if (std::uint64_t(st.st_size) < sizeof(BinaryHeader)) {
+            throw std::runtime_error(std::string(who) + ": truncated");
+        }
+        map_len = std::size_t(st.st_size);
+        void* p = ::mmap(nullptr, map_len, PROT_READ, MAP_SHARED, file.get(), 0);
+        if (p == MAP_FAILED) binary_io::throw_errno(who);
+        map = p;
+
+        BinaryHeader h;
+        std::memcpy(&h, map, sizeof(h));
+        try {
+            binary_io::check_header<T>(h, map_len, who);
+        }
+        catch (...) {
+            unmap();
+            throw;
+        }
+        pre = reinterpret_cast<const T*>(static_cast<const char*>(map) + h.data_offset);
+        pre_len = std::size_t(h.front);
+        suf = pre + pre_len;
+        suf_len = std::size_t(h.size - h.front);
+    }
+
+    MappedDequeView(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+    MappedDequeView(Self&& other) noexcept: MappedDequeView() { swap(other); }
+    Self& operator=(Self&& other) noexcept
+    {
+        Self(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~MappedDequeView() { unmap(); }
+
+    const_reference operator[](size_type pos) const { return *at_unsafe(difference_type(pos)); }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+
+    const_reference front() const { return (*this)[0]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    const_iterator begin() const { return const_iterator(0, this); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const { return const_iterator(difference_type(size()), this); }
+    const_iterator cend() const { return end(); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    size_type size() const noexcept { return pre_len + suf_len; }
+    bool empty() const noexcept { return size() == 0; }
+
+    // The two contiguous pieces, as for acc::Deque.
+    Span<const T> reversed_front_span() const noexcept { return Span<const T>(pre, pre_len); }
+    Span<const T> back_span() const noexcept { return Span<const T>(suf, suf_len); }
+
+    // Tells the kernel how the elements will be read, e.g. MADV_SEQUENTIAL
+    // before a scan or MADV_WILLNEED to prefetch the whole file.
+    void advise(int advice) const
+    {
+        if (map != nullptr && ::madvise(map, map_len, advice) != 0) {
+            binary_io::throw_errno("acc::MappedDequeView::advise");
+        }
+    }
+
+    void swap(Self& other) noexcept
+    {
+        using std::swap;
+        swap(map, other.map);
+        swap(map_len, other.map_len);
+        swap(pre, other.pre);
+        swap(suf, other.suf);
+        swap(pre_len, other.pre_len);
+        swap(suf_len, other.suf_len);
+    }
+
+private:
+
+    void* map;
+    std::size_t map_len;
+    const T* pre;
+    const T* suf;
+    std::size_t pre_len;
+    std::size_t suf_len;
+
+    const_pointer at_unsafe(difference_type pos) const
+    {
+        std::size_t i = std::size_t(pos);
+        if (i < pre_len) return pre + (pre_len - 1 - i);
+        return suf + (i - pre_len);
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size()) {
+            throw std::out_of_range("MappedDequeView::range_check: pos "
+                "(which is " + std::to_string(pos) + ") >= this->size() (which is "
+                + std::to_string(size()) + ")");
+        }
+    }
+
+    void unmap() noexcept
+    {
+        if (map != nullptr) ::munmap(map, map_len);
+        map = nullptr;
+    }
+
+};
+
+template<typename T>
+void swap(MappedDequeView<T>& lhs, MappedDequeView<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc/BinaryIO.hpp.");
+
+#endif
+
+}
+
+#endif
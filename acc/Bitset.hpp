@@ -0,0 +1,572 @@
+// Fixed and dynamic size bitsets with word-parallel operations.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <string>
+#include <stdexcept>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "AccBit.hpp"
+
+#ifndef _ACC_BITSET
+#define _ACC_BITSET
+
+namespace acc
+{
+
+// Both bitsets keep bit i in bit (i % 64) of word i / 64, and the bits past
+// size() in the last word are always zero, so count() and == can work on
+// whole words. The kernels below do the work on word arrays; the binary
+// ones process 256 bits per step with AVX2 or 128 with SSE2 when the
+// compiler targets them (e.g. -mavx2), then finish word by word.
+namespace bits
+{
+
+typedef std::uint64_t Word;
+
+constexpr std::size_t word_bits = 64;
+constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+constexpr std::size_t words_for(std::size_t n) { return (n + word_bits - 1) / word_bits; }
+
+// The bits of the last word that are in use.
+constexpr Word last_mask(std::size_t n)
+{
+    return n % word_bits == 0 ? ~Word(0) : (Word(1) << (n % word_bits)) - 1;
+}
+
+#define _ACC_BITS_OP(Name, expr, avx, sse)                                   \
+struct Name                                                                  \
+{                                                                            \
+    static Word word(Word a, Word b) { return expr; }                        \
+    _ACC_BITS_AVX(static __m256i wide(__m256i a, __m256i b) { return avx; }) \
+    _ACC_BITS_SSE(static __m128i wide(__m128i a, __m128i b) { return sse; }) \
+};
+
+#if defined(__AVX2__)
+#define _ACC_BITS_AVX(x) x
+#define _ACC_BITS_SSE(x)
+#elif defined(__SSE2__)
+#define _ACC_BITS_AVX(x)
+#define _ACC_BITS_SSE(x) x
+#else
+#define _ACC_BITS_AVX(x)
+#define _ACC_BITS_SSE(x)
+#endif
+
+_ACC_BITS_OP(And, a & b, _mm256_and_si256(a, b), _mm_and_si128(a, b))
+_ACC_BITS_OP(Or, a | b, _mm256_or_si256(a, b), _mm_or_si128(a, b))
+_ACC_BITS_OP(Xor, a ^ b, _mm256_xor_si256(a, b), _mm_xor_si128(a, b))
+_ACC_BITS_OP(AndNot, a & ~b, _mm256_andnot_si256(b, a), _mm_andnot_si128(b, a))
+
+#undef _ACC_BITS_OP
+#undef _ACC_BITS_AVX
+#undef _ACC_BITS_SSE
+
+// a[i] = Op(a[i], b[i]) for the first n words.
+template<typename Op>
+inline void apply(Word* a, const Word* b, std::size_t n)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (std::size_t end = n - n % 4; i != end; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), Op::wide(x, y));
+    }
+#elif defined(__SSE2__)
+    for (std::size_t end = n - n % 2; i != end; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i), Op::wide(x, y));
+    }
+#endif
+    for (; i < n; ++i) a[i] = Op::word(a[i], b[i]);
+}
+
+inline std::size_t count(const Word* a, std::size_t n)
+{
+    // Four independent sums so that the popcounts can overlap.
+    std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0, i = 0;
+    for (std::size_t end = n - n % 4; i != end; i += 4) {
+        c0 += acc::popcount(a[i]);
+        c1 += acc::popcount(a[i + 1]);
+        c2 += acc::popcount(a[i + 2]);
+        c3 += acc::popcount(a[i + 3]);
+    }
+    for (; i < n; ++i) c0 += acc::popcount(a[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+inline bool any(const Word* a, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a[i]) return true;
+    }
+    return false;
+}
+
+inline bool equal(const Word* a, const Word* b, std::size_t n)
+{
+    return n == 0 || std::memcmp(a, b, n * sizeof(Word)) == 0;
+}
+
+// The first set bit at or after `from` among the `n` words, or npos.
+inline std::size_t find_from(const Word* a, std::size_t n, std::size_t from)
+{
+    std::size_t i = from / word_bits;
+    if (i >= n) return npos;
+    Word w = a[i] & (~Word(0) << (from % word_bits));
+    while (w == 0) {
+        if (++i == n) return npos;
+        w = a[i];
+    }
+    return i * word_bits + acc::countr_zero(w);
+}
+
+// Moves every bit `s` places towards the higher indices.
+inline void shift_up(Word* a, std::size_t n, std::size_t s)
+{
+    std::size_t ws = s / word_bits, bs = s % word_bits;
+    if (ws >= n) {
+        std::fill(a, a + n, Word(0));
+        return;
+    }
+    for (std::size_t i = n; i-- > ws; ) {
+        Word w = a[i - ws] << bs;
+        if (bs && i > ws) w |= a[i - ws - 1] >> (word_bits - bs);
+        a[i] = w;
+    }
+    std::fill(a, a + ws, Word(0));
+}
+
+// Moves every bit `s` places towards the lower indices.
+inline void shift_down(Word* a, std::size_t n, std::size_t s)
+{
+    std::size_t ws = s / word_bits, bs = s % word_bits;
+    if (ws >= n) {
+        std::fill(a, a + n, Word(0));
+        return;
+    }
+    for (std::size_t i = 0; i + ws < n; ++i) {
+        Word w = a[i + ws] >> bs;
+        if (bs && i + ws + 1 < n) w |= a[i + ws + 1] << (word_bits - bs);
+        a[i] = w;
+    }
+    std::fill(a + (n - ws), a + n, Word(0));
+}
+
+}
+
+#if __cplusplus >= 201103L
+
+template<std::size_t N>
+class Bitset
+{
+
+private:
+
+    typedef Bitset<N> Self;
+    typedef bits::Word Word;
+
+    static constexpr std::size_t W = bits::words_for(N) ? bits::words_for(N) : 1;
+
+public:
+
+    typedef std::size_t     size_type;
+    typedef Word            word_type;
+
+    static constexpr size_type npos = bits::npos;
+
+    Bitset() noexcept: w() { }
+
+    // Bit i is character size() - 1 - i, as for std::bitset.
+    explicit Bitset(const std::string& str)
+    {
+        from_string(w, str, N);
+    }
+
+    constexpr size_type size() const noexcept { return N; }
+
+    bool test(size_type pos) const
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+    bool operator[](size_type pos) const
+    {
+        return (w[pos / bits::word_bits] >> (pos % bits::word_bits)) & 1;
+    }
+
+    Self& set() noexcept
+    {
+        std::fill(w, w + W, ~Word(0));
+        trim();
+        return *this;
+    }
+    Self& set(size_type pos, bool value = true)
+    {
+        range_check(pos);
+        Word m = Word(1) << (pos % bits::word_bits);
+        if (value) w[pos / bits::word_bits] |= m;
+        else w[pos / bits::word_bits] &= ~m;
+        return *this;
+    }
+    Self& reset() noexcept
+    {
+        std::fill(w, w + W, Word(0));
+        return *this;
+    }
+    Self& reset(size_type pos) { return set(pos, false); }
+    Self& flip() noexcept
+    {
+        for (size_type i = 0; i < W; ++i) w[i] = ~w[i];
+        trim();
+        return *this;
+    }
+    Self& flip(size_type pos)
+    {
+        range_check(pos);
+        w[pos / bits::word_bits] ^= Word(1) << (pos % bits::word_bits);
+        return *this;
+    }
+
+    size_type count() const noexcept { return bits::count(w, W); }
+    bool any() const noexcept { return bits::any(w, W); }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == N; }
+
+    // Positions of set bits in increasing order; npos when there is none.
+    size_type find_first() const noexcept { return bits::find_from(w, W, 0); }
+    size_type find_next(size_type pos) const noexcept
+    {
+        return pos + 1 >= N ? npos : bits::find_from(w, W, pos + 1);
+    }
+
+    Self& operator&=(const Self& o) noexcept
+    {
+        bits::apply<bits::And>(w, o.w, W);
+        return *this;
+    }
+    Self& operator|=(const Self& o) noexcept
+    {
+        bits::apply<bits::Or>(w, o.w, W);
+        return *this;
+    }
+    Self& operator^=(const Self& o) noexcept
+    {
+        bits::apply<bits::Xor>(w, o.w, W);
+        return *this;
+    }
+    // *this &= ~o, without building ~o.
+    Self& and_not(const Self& o) noexcept
+    {
+        bits::apply<bits::AndNot>(w, o.w, W);
+        return *this;
+    }
+    Self& operator<<=(size_type s) noexcept
+    {
+        bits::shift_up(w, W, s);
+        trim();
+        return *this;
+    }
+    Self& operator>>=(size_type s) noexcept
+    {
+        bits::shift_down(w, W, s);
+        return *this;
+    }
+
+    Self operator~() const noexcept { return Self(*this).flip(); }
+    Self operator<<(size_type s) const noexcept { return Self(*this) <<= s; }
+    Self operator>>(size_type s) const noexcept { return Self(*this) >>= s; }
+
+    bool operator==(const Self& o) const noexcept { return bits::equal(w, o.w, W); }
+    bool operator!=(const Self& o) const noexcept { return !(*this == o); }
+
+    // The underlying words, bit i in word i / 64.
+    Word* data() noexcept { return w; }
+    const Word* data() const noexcept { return w; }
+    static constexpr size_type word_count() noexcept { return bits::words_for(N); }
+
+    std::string to_string(char zero = '0', char one = '1') const
+    {
+        std::string res(N, zero);
+        for (size_type i = find_first(); i != npos; i = find_next(i)) res[N - 1 - i] = one;
+        return res;
+    }
+
+private:
+
+    Word w[W];
+
+    void trim() noexcept
+    {
+        if (N % bits::word_bits) w[W - 1] &= bits::last_mask(N);
+        else if (N == 0) w[0] = 0;
+    }
+
+    static void from_string(Word* words, const std::string& str, size_type n)
+    {
+        std::fill(words, words + bits::words_for(n), Word(0));
+        size_type len = std::min(str.size(), n);
+        for (size_type i = 0; i < len; ++i) {
+            char c = str[str.size() - 1 - i];
+            if (c == '1') words[i / bits::word_bits] |= Word(1) << (i % bits::word_bits);
+            else if (c != '0') throw std::invalid_argument("Bitset: not a binary digit");
+        }
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= N)
+        {
+            throw std::out_of_range("Bitset::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(N) + ")");
+        }
+    }
+
+};
+
+template<std::size_t N>
+constexpr std::size_t Bitset<N>::npos;
+
+template<std::size_t N>
+Bitset<N> operator&(const Bitset<N>& a, const Bitset<N>& b) { return Bitset<N>(a) &= b; }
+template<std::size_t N>
+Bitset<N> operator|(const Bitset<N>& a, const Bitset<N>& b) { return Bitset<N>(a) |= b; }
+template<std::size_t N>
+Bitset<N> operator^(const Bitset<N>& a, const Bitset<N>& b) { return Bitset<N>(a) ^= b; }
+
+// A bitset whose size is chosen at run time. The binary operations require
+// both operands to have the same size.
+template<typename Alloc = std::allocator<bits::Word>>
+class BasicDynamicBitset
+{
+
+private:
+
+    typedef BasicDynamicBitset<Alloc> Self;
+    typedef bits::Word Word;
+
+public:
+
+    typedef std::size_t     size_type;
+    typedef Word            word_type;
+    typedef Alloc           allocator_type;
+
+    static constexpr size_type npos = bits::npos;
+
+    explicit BasicDynamicBitset(const allocator_type& alloc = allocator_type())
+        : w(alloc), n(0) { }
+    explicit BasicDynamicBitset(size_type count, bool value = false,
+        const allocator_type& alloc = allocator_type())
+        : w(bits::words_for(count), value ? ~Word(0) : Word(0), alloc), n(count)
+    {
+        trim();
+    }
+
+    size_type size() const noexcept { return n; }
+    bool empty() const noexcept { return n == 0; }
+
+    void resize(size_type count, bool value = false)
+    {
+        size_type old = n;
+        w.resize(bits::words_for(count), value ? ~Word(0) : Word(0));
+        n = count;
+        if (value && count > old && old % bits::word_bits) {
+            w[old / bits::word_bits] |= ~bits::last_mask(old);
+        }
+        trim();
+    }
+    void push_back(bool value)
+    {
+        if (n % bits::word_bits == 0) w.push_back(Word(0));
+        ++n;
+        if (value) w.back() |= Word(1) << ((n - 1) % bits::word_bits);
+    }
+    void clear() noexcept
+    {
+        w.clear();
+        n = 0;
+    }
+
+    bool test(size_type pos) const
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+    bool operator[](size_type pos) const
+    {
+        return (w[pos / bits::word_bits] >> (pos % bits::word_bits)) & 1;
+    }
+
+    Self& set() noexcept
+    {
+        std::fill(w.begin(), w.end(), ~Word(0));
+        trim();
+        return *this;
+    }
+    Self& set(size_type pos, bool value = true)
+    {
+        range_check(pos);
+        Word m = Word(1) << (pos % bits::word_bits);
+        if (value) w[pos / bits::word_bits] |= m;
+        else w[pos / bits::word_bits] &= ~m;
+        return *this;
+    }
+    Self& reset() noexcept
+    {
+        std::fill(w.begin(), w.end(), Word(0));
+        return *this;
+    }
+    Self& reset(size_type pos) { return set(pos, false); }
+    Self& flip() noexcept
+    {
+        for (Word& x: w) x = ~x;
+        trim();
+        return *this;
+    }
+    Self& flip(size_type pos)
+    {
+        range_check(pos);
+        w[pos / bits::word_bits] ^= Word(1) << (pos % bits::word_bits);
+        return *this;
+    }
+
+    size_type count() const noexcept { return bits::count(w.data(), w.size()); }
+    bool any() const noexcept { return bits::any(w.data(), w.size()); }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == n; }
+
+    size_type find_first() const noexcept { return bits::find_from(w.data(), w.size(), 0); }
+    size_type find_next(size_type pos) const noexcept
+    {
+        return pos + 1 >= n ? npos : bits::find_from(w.data(), w.size(), pos + 1);
+    }
+
+    Self& operator&=(const Self& o) noexcept
+    {
+        bits::apply<bits::And>(w.data(), o.w.data(), w.size());
+        return *this;
+    }
+    Self& operator|=(const Self& o) noexcept
+    {
+        bits::apply<bits::Or>(w.data(), o.w.data(), w.size());
+        return *this;
+    }
+    Self& operator^=(const Self& o) noexcept
+    {
+        bits::apply<bits::Xor>(w.data(), o.w.data(), w.size());
+        return *this;
+    }
+    Self& and_not(const Self& o) noexcept
+    {
+        bits::apply<bits::AndNot>(w.data(), o.w.data(), w.size());
+        return *this;
+    }
+    Self& operator<<=(size_type s) noexcept
+    {
+        bits::shift_up(w.data(), w.size(), s);
+        trim();
+        return *this;
+    }
+    Self& operator>>=(size_type s) noexcept
+    {
+        bits::shift_down(w.data(), w.size(), s);
+        return *this;
+    }
+
+    Self operator~() const { return Self(*this).flip(); }
+    Self operator<<(size_type s) const { return Self(*this) <<= s; }
+    Self operator>>(size_type s) const { return Self(*this) >>= s; }
+
+    bool operator==(const Self& o) const noexcept
+    {
+        return n == o.n && bits::equal(w.data(), o.w.data(), w.size());
+    }
+    bool operator!=(const Self& o) const noexcept { return !(*this == o); }
+
+    Word* data() noexcept { return w.data(); }
+    const Word* data() const noexcept { return w.data(); }
+    size_type word_count() const noexcept { return w.size(); }
+
+private:
+
+    std::vector<Word, Alloc> w;
+    size_type n;
+
+    void trim() noexcept
+    {
+        if (n % bits::word_bits) w.back() &= bits::last_mask(n);
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= n)
+        {
+            throw std::out_of_range("DynamicBitset::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(n) + ")");
+        }
+    }
+
+};
+
+template<typename Alloc>
+constexpr std::size_t BasicDynamicBitset<Alloc>::npos;
+
+typedef BasicDynamicBitset<> DynamicBitset;
+
+template<typename Alloc>
+BasicDynamicBitset<Alloc> operator&(const BasicDynamicBitset<Alloc>& a,
+                                    const BasicDynamicBitset<Alloc>& b)
+{
+    return BasicDynamicBitset<Alloc>(a) &= b;
+}
+template<typename Alloc>
+BasicDynamicBitset<Alloc> operator|(const BasicDynamicBitset<Alloc>& a,
+                                    const BasicDynamicBitset<Alloc>& b)
+{
+    return BasicDynamicBitset<Alloc>(a) |= b;
+}
+template<typename Alloc>
+BasicDynamicBitset<Alloc> operator^(const BasicDynamicBitset<Alloc>& a,
+                                    const BasicDynamicBitset<Alloc>& b)
+{
+    return BasicDynamicBitset<Alloc>(a) ^= b;
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::Bitset.");
+
+#endif
+
+}
+
+#endif
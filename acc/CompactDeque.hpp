@@ -0,0 +1,486 @@
+// A deque that is a single pointer.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <initializer_list>
+
+#include "Deque.hpp"
+#include "IndexingIterator.hpp"
+
+#ifndef _ACC_COMPACT_DEQUE
+#define _ACC_COMPACT_DEQUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// The two blocks of acc::Deque, `pre` (the front, reversed) and `suf`, share
+// one allocation that starts with a header holding both sizes and both
+// capacities:
+//
+//     [pre_size pre_cap suf_size suf_cap][pre: pre_cap slots][suf: suf_cap slots]
+//
+// The object itself is only the pointer to it, null while nothing has been
+// pushed, plus the allocator and the RebuildPolicy, which are empty bases for
+// std::allocator and the stateless policies. So sizeof(CompactDeque<T>) is
+// the size of a pointer, against three pointers per block for acc::Deque.
+//
+// Random access is that of acc::Deque: position i < pre_size is
+// pre[pre_size - 1 - i], the others are suf[i - pre_size]. Pops rebuild the
+// same way. When a block is full the whole allocation is replaced; the block
+// grows by at least half of the total size, so the elements of the other
+// block are moved an amortised constant number of times.
+//
+// Iterators hold positions, so they survive a reallocation, but a push or
+// pop at the front shifts the element they refer to.
+template<typename T, typename Alloc = std::allocator<T>,
+         typename RebuildPolicy = HalfRebuild>
+class CompactDeque : private Alloc, private RebuildPolicy
+{
+
+private:
+
+    typedef CompactDeque<T, Alloc, RebuildPolicy> Self;
+    typedef std::allocator_traits<Alloc> AllocTraits;
+
+public:
+
+    DERIVE_ACC_INDEXING_ITERATOR(_Iterator, at_unsafe)
+
+    typedef T                                           value_type;
+    typedef Alloc                                       allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef _Iterator<T&, pointer>                      iterator;
+    typedef _Iterator<const T&, const_pointer>          const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    explicit CompactDeque(const allocator_type& alloc): Alloc(alloc) { }
+    CompactDeque(): CompactDeque(allocator_type()) { }
+    CompactDeque(size_type count, const value_type& value,
+        const allocator_type& alloc = allocator_type()): CompactDeque(alloc)
+    {
+        reserve(count);
+        while (count--) push_back(value);
+    }
+    explicit CompactDeque(size_type count,
+        const allocator_type& alloc = allocator_type()): CompactDeque(alloc)
+    {
+        reserve(count);
+        while (count--) emplace_back();
+    }
+    template<typename InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    CompactDeque(InputIt first, InputIt last,
+        const allocator_type& alloc = allocator_type()): CompactDeque(alloc)
+    {
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    CompactDeque(const Self& other)
+        : Alloc(AllocTraits::select_on_container_copy_construction(other.get_al())),
+          RebuildPolicy(other.policy())
+    {
+        reserve(other.size());
+        for (const value_type& x: other) push_back(x);
+    }
+    CompactDeque(Self&& other) noexcept
+        : Alloc(std::move(other.get_al())), RebuildPolicy(std::move(other.policy())),
+          block(other.block)
+    {
+        other.block = nullptr;
+    }
+    CompactDeque(std::initializer_list<value_type> init,
+        const allocator_type& alloc = allocator_type())
+        : CompactDeque(init.begin(), init.end(), alloc) { }
+
+    ~CompactDeque() { release(); }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            get_al() = std::move(other.get_al());
+            policy() = std::move(other.policy());
+            block = other.block;
+            other.block = nullptr;
+        }
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<class InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    void assign(size_type count, const value_type& value)
+    {
+        clear();
+        reserve(count);
+        while (count--) push_back(value);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept { return get_al(); }
+
+    reference operator[](size_type pos) { return *at_unsafe(difference_type(pos)); }
+    const_reference operator[](size_type pos) const
+    {
+        return *const_cast<Self*>(this)->at_unsafe(difference_type(pos));
+    }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    iterator begin() { return iterator(0, this); }
+    const_iterator begin() const { return const_iterator(0, this); }
+    const_iterator cbegin() const { return const_iterator(0, this); }
+    iterator end() { return iterator(difference_type(size()), this); }
+    const_iterator end() const { return const_iterator(difference_type(size()), this); }
+    const_iterator cend() const { return const_iterator(difference_type(size()), this); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+
+    size_type size() const { return block ? block->pre_size + block->suf_size : 0; }
+    bool empty() const { return size() == 0; }
+    size_type max_size() const
+    {
+        return (AllocTraits::max_size(get_al()) - sizeof(Header)) / 2;
+    }
+    // Slots of both blocks together.
+    size_type capacity() const { return block ? block->pre_cap + block->suf_cap : 0; }
+
+    // Destroys the elements and keeps the allocation.
+    void clear()
+    {
+        if (block == nullptr) return;
+        destroy_n(pre(), block->pre_size);
+        destroy_n(suf(), block->suf_size);
+        block->pre_size = block->suf_size = 0;
+    }
+
+    // Makes room for pushing back up to `new_cap` elements in all.
+    void reserve(size_type new_cap)
+    {
+        size_type pre_size = block ? block->pre_size : 0;
+        size_type suf_cap = block ? block->suf_cap : 0;
+        if (new_cap > pre_size && new_cap - pre_size > suf_cap) {
+            reallocate(block ? block->pre_cap : 0, new_cap - pre_size);
+        }
+    }
+
+    // An empty deque goes back to the null pointer.
+    void shrink_to_fit()
+    {
+        if (empty()) release();
+        else if (size() < capacity()) reallocate(block->pre_size, block->suf_size);
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+    void push_front(const value_type& val) { emplace_front(val); }
+    void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        pointer p;
+        if (block == nullptr || block->suf_size == block->suf_cap) {
+            // args may refer to an element, which reallocate() moves.
+            value_type tmp(std::forward<Args>(args)...);
+            size_type pre_cap = block ? block->pre_cap : 0;
+            reallocate(pre_cap, grown(block ? block->suf_cap : 0));
+            p = suf() + block->suf_size;
+            AllocTraits::construct(get_al(), p, std::move(tmp));
+        }
+        else {
+            p = suf() + block->suf_size;
+            AllocTraits::construct(get_al(), p, std::forward<Args>(args)...);
+        }
+        ++block->suf_size;
+        RebuildPolicy::pushed_back();
+        return *p;
+    }
+
+    template<class... Args>
+    reference emplace_front(Args&&... args)
+    {
+        pointer p;
+        if (block == nullptr || block->pre_size == block->pre_cap) {
+            value_type tmp(std::forward<Args>(args)...);
+            size_type suf_cap = block ? block->suf_cap : 0;
+            reallocate(grown(block ? block->pre_cap : 0), suf_cap);
+            p = pre() + block->pre_size;
+            AllocTraits::construct(get_al(), p, std::move(tmp));
+        }
+        else {
+            p = pre() + block->pre_size;
+            AllocTraits::construct(get_al(), p, std::forward<Args>(args)...);
+        }
+        ++block->pre_size;
+        RebuildPolicy::pushed_front();
+        return *p;
+    }
+
+    void pop_back()
+    {
+        if (block->suf_size == 0) rebuild(false);
+        AllocTraits::destroy(get_al(), suf() + --block->suf_size);
+    }
+
+    void pop_front()
+    {
+        if (block->pre_size == 0) rebuild(true);
+        AllocTraits::destroy(get_al(), pre() + --block->pre_size);
+    }
+
+    void swap(Self& other) noexcept
+    {
+        using std::swap;
+        swap(get_al(), other.get_al());
+        swap(policy(), other.policy());
+        swap(block, other.block);
+    }
+
+private:
+
+    struct Header
+    {
+        size_type pre_size, pre_cap;
+        size_type suf_size, suf_cap;
+    };
+
+    // The allocation is counted in units aligned for both the header and T.
+    static constexpr size_type unit_align =
+        alignof(T) > alignof(Header) ? alignof(T) : alignof(Header);
+    struct alignas(unit_align) Unit { unsigned char bytes[unit_align]; };
+    static constexpr size_type data_offset =
+        (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    typedef typename AllocTraits::template rebind_alloc<Unit> UnitAlloc;
+    typedef std::allocator_traits<UnitAlloc> UnitTraits;
+
+    Header* block = nullptr;
+
+    Alloc& get_al() noexcept { return *this; }
+    const Alloc& get_al() const noexcept { return *this; }
+    RebuildPolicy& policy() noexcept { return *this; }
+    const RebuildPolicy& policy() const noexcept { return *this; }
+
+    static pointer pre_of(Header* h)
+    {
+        return reinterpret_cast<pointer>(reinterpret_cast<unsigned char*>(h) + data_offset);
+    }
+    pointer pre() const { return pre_of(block); }
+    pointer suf() const { return pre() + block->pre_cap; }
+
+    pointer at_unsafe(difference_type pos)
+    {
+        size_type i = size_type(pos);
+        if (i < block->pre_size) return pre() + (block->pre_size - 1 - i);
+        return suf() + (i - block->pre_size);
+    }
+
+    static size_type units(size_type slots)
+    {
+        return (data_offset + slots * sizeof(T) + unit_align - 1) / unit_align;
+    }
+
+    // The new capacity of a full block: doubled, and at least half the size
+    // of the deque, which bounds how often the other block is moved.
+    size_type grown(size_type cap) const
+    {
+        size_type c = std::max(2 * cap, size() / 2);
+        return c < 1 ? 1 : c;
+    }
+
+    void destroy_n(pointer p, size_type n)
+    {
+        for (size_type i = 0; i < n; ++i) AllocTraits::destroy(get_al(), p + i);
+    }
+
+    // Moves both blocks into a new allocation with the given capacities,
+    // which must hold them.
+    void reallocate(size_type pre_cap, size_type suf_cap)
+    {
+        UnitAlloc ua(get_al());
+        Unit* mem = UnitTraits::allocate(ua, units(pre_cap + suf_cap));
+        Header* h = ::new (static_cast<void*>(mem)) Header();
+        h->pre_cap = pre_cap, h->suf_cap = suf_cap;
+        if (block) {
+            pointer to = pre_of(h), from = pre();
+            try {
+                for (; h->pre_size < block->pre_size; ++h->pre_size) {
+                    AllocTraits::construct(get_al(), to + h->pre_size,
+                                           std::move_if_noexcept(from[h->pre_size]));
+                }
+                to += pre_cap, from = suf();
+                for (; h->suf_size < block->suf_size; ++h->suf_size) {
+                    AllocTraits::construct(get_al(), to + h->suf_size,
+                                           std::move_if_noexcept(from[h->suf_size]));
+                }
+            }
+            catch (...) {
+                destroy_n(pre_of(h), h->pre_size);
+                destroy_n(pre_of(h) + pre_cap, h->suf_size);
+                UnitTraits::deallocate(ua, mem, units(pre_cap + suf_cap));
+                throw;
+            }
+        }
+        release();
+        block = h;
+    }
+
+    void release() noexcept
+    {
+        if (block == nullptr) return;
+        clear();
+        UnitAlloc ua(get_al());
+        UnitTraits::deallocate(ua, reinterpret_cast<Unit*>(block),
+                               units(block->pre_cap + block->suf_cap));
+        block = nullptr;
+    }
+
+    // As in acc::Deque: the block popped from is empty, so the first (for
+    // `to_front`) or last elements of the other block are moved into it in
+    // reverse order and the gap they leave is closed.
+    void rebuild(bool to_front)
+    {
+        size_type n = split(to_front ? block->suf_size : block->pre_size, to_front);
+        if ((to_front ? block->pre_cap : block->suf_cap) < n) {
+            if (to_front) reallocate(n, block->suf_cap);
+            else reallocate(block->pre_cap, n);
+        }
+        pointer from = to_front ? suf() : pre(), to = to_front ? pre() : suf();
+        size_type& fsize = to_front ? block->suf_size : block->pre_size;
+        size_type& tsize = to_front ? block->pre_size : block->suf_size;
+        try {
+            for (; tsize < n; ++tsize) {
+                AllocTraits::construct(get_al(), to + tsize,
+                                       std::move_if_noexcept(from[n - 1 - tsize]));
+            }
+        }
+        catch (...) {
+            destroy_n(to, tsize);
+            tsize = 0;
+            throw;
+        }
+        std::move(from + n, from + fsize, from);
+        destroy_n(from + (fsize - n), n);
+        fsize -= n;
+    }
+
+    size_type split(size_type n, bool to_front)
+    {
+        size_type k = RebuildPolicy::split(n, to_front);
+        return k < 1 ? 1 : (k > n ? n : k);
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("CompactDeque::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
+};
+
+template<typename T, typename Alloc, typename Policy>
+void swap(CompactDeque<T, Alloc, Policy>& lhs, CompactDeque<T, Alloc, Policy>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<typename T, typename Alloc, typename Policy>
+bool operator==(const CompactDeque<T, Alloc, Policy>& lhs,
+                const CompactDeque<T, Alloc, Policy>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename T, typename Alloc, typename Policy>
+bool operator!=(const CompactDeque<T, Alloc, Policy>& lhs,
+                const CompactDeque<T, Alloc, Policy>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<typename T, typename Alloc, typename Policy>
+bool operator<(const CompactDeque<T, Alloc, Policy>& lhs,
+               const CompactDeque<T, Alloc, Policy>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::CompactDeque.");
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,215 @@
+// A thread-safe deque with one lock per end.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+
+#include "Deque.hpp"
+
+#ifndef _ACC_CONCURRENT_DEQUE
+#define _ACC_CONCURRENT_DEQUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+#ifndef ACC_CACHE_LINE
+#define ACC_CACHE_LINE 64
+#endif
+
+// The layout of acc::Deque, with the front block `pre` and the back block
+// `suf` each behind its own mutex. Operations at one end take only that
+// end's lock, so threads working at different ends do not contend. Only a
+// rebuild, when a pop finds its block empty, needs both blocks; it then
+// drops its lock and takes both, the front one first, so two rebuilds can
+// not deadlock. The RebuildPolicy is that of acc::Deque; QueueRebuild suits
+// producers at one end and consumers at the other. pushed_front() and
+// pushed_back() run under different locks, so they must not share state,
+// which holds for the policies in Deque.hpp.
+//
+// The blocking pops sleep on a condition variable while the deque is empty.
+// A push wakes them only when a thread is actually waiting, which it learns
+// from an atomic counter, so pushes normally never touch that mutex.
+template<typename T, typename Container = std::vector<T>,
+         typename RebuildPolicy = HalfRebuild>
+class ConcurrentDeque
+{
+
+private:
+
+    typedef ConcurrentDeque<T, Container, RebuildPolicy> Self;
+    typedef Container Vec;
+    typedef std::unique_lock<std::mutex> Lock;
+
+public:
+
+    typedef T                                           value_type;
+    typedef typename Vec::size_type                     size_type;
+
+    ConcurrentDeque() = default;
+    ConcurrentDeque(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+    // A snapshot, may be stale by the time it is used.
+    size_type size() const noexcept { return count.load(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+    void push_front(const value_type& val) { emplace_front(val); }
+    void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+    template<class... Args>
+    void emplace_back(Args&&... args)
+    {
+        {
+            Lock lock(back.m);
+            back.v.emplace_back(std::forward<Args>(args)...);
+            policy.pushed_back();
+            // Under the lock, so no pop can take the element before it
+            // is counted.
+            ++count;
+        }
+        notify();
+    }
+
+    template<class... Args>
+    void emplace_front(Args&&... args)
+    {
+        {
+            Lock lock(front.m);
+            front.v.emplace_back(std::forward<Args>(args)...);
+            policy.pushed_front();
+            ++count;
+        }
+        notify();
+    }
+
+    // Move the element at that end into `out`; false when the deque is
+    // empty.
+    bool try_pop_front(value_type& out)
+    {
+        {
+            Lock lock(front.m);
+            if (!front.v.empty()) return take(front.v, out);
+        }
+        Lock lf(front.m), lb(back.m);
+        if (front.v.empty()) {
+            if (back.v.empty()) return false;
+            relocate(back.v, front.v, split(back.v.size(), true));
+        }
+        return take(front.v, out);
+    }
+
+    bool try_pop_back(value_type& out)
+    {
+        {
+            Lock lock(back.m);
+            if (!back.v.empty()) return take(back.v, out);
+        }
+        Lock lf(front.m), lb(back.m);
+        if (back.v.empty()) {
+            if (front.v.empty()) return false;
+            relocate(front.v, back.v, split(front.v.size(), false));
+        }
+        return take(back.v, out);
+    }
+
+    // Wait until there is an element to pop.
+    void pop_front(value_type& out)
+    {
+        while (!try_pop_front(out)) wait();
+    }
+
+    void pop_back(value_type& out)
+    {
+        while (!try_pop_back(out)) wait();
+    }
+
+private:
+
+    struct alignas(ACC_CACHE_LINE) End
+    {
+        std::mutex m;
+        Vec v;
+    };
+
+    End front;
+    End back;
+    RebuildPolicy policy;
+
+    alignas(ACC_CACHE_LINE) std::atomic<size_type> count{0};
+    std::atomic<size_type> waiters{0};
+    std::mutex wait_m;
+    std::condition_variable wait_cv;
+
+    bool take(Vec& v, value_type& out)
+    {
+        out = std::move(v.back());
+        v.pop_back();
+        --count;
+        return true;
+    }
+
+    // Called after a push raised `count`. `count` is raised before `waiters`
+    // is read and a waiter registers before it reads `count`; both are
+    // sequentially consistent, so either the waiter sees the element or the
+    // push sees the waiter.
+    void notify()
+    {
+        if (waiters.load() != 0) {
+            std::lock_guard<std::mutex> lock(wait_m);
+            wait_cv.notify_all();
+        }
+    }
+
+    void wait()
+    {
+        Lock lock(wait_m);
+        ++waiters;
+        wait_cv.wait(lock, [this] { return count.load() != 0; });
+        --waiters;
+    }
+
+    size_type split(size_type n, bool to_front)
+    {
+        size_type k = policy.split(n, to_front);
+        return k < 1 ? 1 : (k > n ? n : k);
+    }
+
+    static void relocate(Vec& from, Vec& to, size_type n)
+    {
+        relocate_reversed(from, to, n);
+    }
+
+};
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::ConcurrentDeque.");
+
+#endif
+
+}
+
+#endif
@@ -22,8 +22,13 @@
 #include <algorithm>
 #include <type_traits>
 #include <stdexcept>
+#include <iterator>
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <functional>
 
-#include "IndexingIterator.hpp"
+#include "Span.hpp"
 
 #ifndef _ACC_DEQUE
 #define _ACC_DEQUE
@@ -39,18 +44,173 @@ namespace acc
 
 #if __cplusplus >= 201103L
 
-template<typename T, typename Container = std::vector<T>>
-class Deque
+// Rebuild policies decide how many elements move to the empty block when an
+// element is popped from it. split(n, front) gets the size n of the other
+// block and whether the front block is being refilled, and returns a number
+// in [1, n]. pushed_front() and pushed_back() are called on every push.
+
+// Splits the sequence in halves. Right for deques used at both ends.
+struct HalfRebuild
+{
+    std::size_t split(std::size_t n, bool) const { return n - n / 2; }
+    void pushed_front() { }
+    void pushed_back() { }
+};
+
+// Moves every element. Right for FIFO queues (push_back and pop_front only),
+// where elements left in the back block would be moved again later.
+struct QueueRebuild
+{
+    std::size_t split(std::size_t n, bool) const { return n; }
+    void pushed_front() { }
+    void pushed_back() { }
+};
+
+// Counts the pushes at each end. The more of them went to the opposite end,
+// the more elements it moves, from half of the block when the pushes were
+// balanced to all of it when they all went there. The counts are halved on
+// every rebuild, so a single burst at one end does not flip the split.
+struct AdaptiveRebuild
+{
+    std::size_t front = 0, back = 0;
+
+    std::size_t split(std::size_t n, bool to_front)
+    {
+        std::size_t same = to_front ? front : back, other = to_front ? back : front;
+        std::size_t half = n - n / 2, extra = 0;
+        if (other > same) {
+            extra = static_cast<std::size_t>(static_cast<double>(n / 2)
+                * static_cast<double>(other - same) / static_cast<double>(other + same));
+        }
+        front /= 2, back /= 2;
+        return half + extra;
+    }
+    void pushed_front() { ++front; }
+    void pushed_back() { ++back; }
+};
+
+// The rebuild step: moves the first `count` elements of `from` into the
+// empty `to` in reverse order, then closes the gap in `from` in place.
+// Elements are relocated with `move_if_noexcept`, and only `to` may allocate,
+// when its capacity is less than `count`. A Container can provide a faster
+// overload, found by argument-dependent lookup.
+template<typename Vec>
+void relocate_reversed(Vec& from, Vec& to, typename Vec::size_type count)
+{
+    to.reserve(count);
+    try {
+        for (typename Vec::size_type i = count; i > 0; --i) {
+            to.push_back(std::move_if_noexcept(from[i - 1]));
+        }
+    }
+    catch (...) {
+        to.clear();
+        throw;
+    }
+    std::move(from.begin() + count, from.end(), from.begin());
+    from.erase(from.end() - count, from.end());
+}
+
+template<typename T, typename Container = std::vector<T>,
+         typename RebuildPolicy = HalfRebuild>
+class Deque : private RebuildPolicy
 {
 
 private:
 
-    typedef Deque<T> Self;
+    typedef Deque<T, Container, RebuildPolicy> Self;
     typedef Container Vec;
 
 public:
 
-    DERIVE_ACC_INDEXING_ITERATOR(_Iterator, at_unsafe)
+    // Position `cur` is relative to the seam between the blocks: the element
+    // at cur < 0 is pre[-cur - 1] and the one at cur >= 0 is suf[cur]. The
+    // iterator also caches the address of its element, so dereferencing is a
+    // single load. Stepping moves backwards through pre and forwards through
+    // suf, and looks at the deque only when it crosses the seam or jumps;
+    // `step` is the direction of ++ in memory, so a step is one add and one
+    // compare with the seam.
+    // Like the std iterators, only iterators of the same deque compare.
+    template<typename Ref, typename Ptr>
+    class _Iterator
+    {
+    private:
+
+        typedef _Iterator<Ref, Ptr> Iter;
+
+    public:
+        typedef T                                           value_type;
+        typedef std::size_t                                 size_type;
+        typedef std::ptrdiff_t                              difference_type;
+        typedef Ref                                         reference;
+        typedef Ptr                                         pointer;
+        typedef std::random_access_iterator_tag             iterator_category;
+
+        difference_type cur;
+        Self* s;
+        pointer p;
+        difference_type step;
+
+        _Iterator(): cur(), s(nullptr), p(), step(1) { }
+        _Iterator(difference_type _c, Self* _s)
+            : cur(_c), s(_s), p(_s->at_unsafe(_c)), step(_c < 0 ? -1 : 1) { }
+        _Iterator(difference_type _c, const Self* _s)
+            : cur(_c), s(const_cast<Self*>(_s)), p(s->at_unsafe(_c)), step(_c < 0 ? -1 : 1) { }
+        template<typename _Iter, typename = typename std::enable_if<
+            std::is_same<Iter, _Iterator<const T&, typename Self::const_pointer>>::value
+            && std::is_same<_Iter, _Iterator<T&, typename Self::pointer>>::value>::type>
+        _Iterator(const _Iter& __x): cur(__x.cur), s(__x.s), p(__x.p), step(__x.step) { }
+        _Iterator(const _Iterator& __x) = default;
+        _Iterator& operator=(const _Iterator& t) = default;
+
+        reference operator*() const { return *p; }
+        pointer operator->() const { return p; }
+        reference operator[](difference_type n) const { return *((*this) + n); }
+
+        Iter& operator++()
+        {
+            if (++cur == 0) p = s->suf.data(), step = 1;
+            else p += step;
+            return *this;
+        }
+        Iter operator++(int)
+        {
+            Iter copy = *this;
+            ++(*this);
+            return copy;
+        }
+        Iter& operator--()
+        {
+            if (--cur == -1) p = s->pre.data(), step = -1;
+            else p -= step;
+            return *this;
+        }
+        Iter operator--(int)
+        {
+            Iter copy = *this;
+            --(*this);
+            return copy;
+        }
+        Iter& operator+=(difference_type n)
+        {
+            cur += n;
+            p = s->at_unsafe(cur);
+            step = cur < 0 ? -1 : 1;
+            return *this;
+        }
+        Iter& operator-=(difference_type n) { return (*this) += -n; }
+        Iter operator+(difference_type n) const { return Iter(cur + n, s); }
+        friend Iter operator+(difference_type n, const Iter& th) { return th + n; }
+        Iter operator-(difference_type n) const { return Iter(cur - n, s); }
+        difference_type operator-(const Iter& t) const { return cur - t.cur; }
+
+        bool operator==(const Iter& t) const { return cur == t.cur; }
+        bool operator!=(const Iter& t) const { return !(*this == t); }
+        bool operator<(const Iter& t) const { return cur < t.cur; }
+        bool operator>(const Iter& t) const { return t < *this; }
+        bool operator>=(const Iter& t) const { return !(*this < t); }
+        bool operator<=(const Iter& t) const { return !(t < *this); }
+    };
 
     typedef T                                           value_type;
     typedef typename Vec::allocator_type                allocator_type;
@@ -58,8 +218,8 @@ public:
     typedef typename Vec::difference_type               difference_type;
     typedef typename Vec::reference                     reference;
     typedef typename Vec::const_reference               const_reference;
-    typedef typename Vec::iterator                      pointer;
-    typedef typename Vec::const_iterator                const_pointer;
+    typedef typename std::allocator_traits<allocator_type>::pointer pointer;
+    typedef typename std::allocator_traits<allocator_type>::const_pointer const_pointer;
     typedef _Iterator<T&, pointer>                      iterator;
     typedef _Iterator<const T&, const_pointer>          const_iterator;
     typedef std::reverse_iterator<iterator>             reverse_iterator;
@@ -74,33 +234,36 @@ public:
     explicit Deque(size_type count, const allocator_type& alloc = allocator_type())
         : pre(alloc), suf(count, alloc) { }
 
-    template<typename InputIt> 
+    template<typename InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
     Deque(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
         : pre(alloc), suf(first, last, alloc) { }
 
     Deque(const Self& other, const allocator_type& alloc = allocator_type())
-        : pre(other.pre, alloc), suf(other.suf, alloc) { }
+        : RebuildPolicy(other.policy()), pre(other.pre, alloc), suf(other.suf, alloc) { }
     Deque(Self&& other): Deque() 
     {
-        pre.swap(other.pre);
-        suf.swap(other.suf);
+        swap(other);
     }
     Deque(std::initializer_list<value_type> init, const allocator_type& alloc = allocator_type())
         : pre(alloc), suf(init, alloc) { }
 
-    Deque operator=(const Self& other)
+    Self& operator=(const Self& other)
     {
         pre = other.pre, suf = other.suf;
+        policy() = other.policy();
+        return *this;
     }
-    Deque operator=(Self&& other)
+    Self& operator=(Self&& other)
     {
-        pre.swap(other.pre);
-        suf.swap(other.suf);
+        swap(other);
+        return *this;
     }
-    Deque operator=(std::initializer_list<value_type> ilist)
+    Self& operator=(std::initializer_list<value_type> ilist)
     {
         pre.clear();
         suf.assign(ilist);
+        return *this;
     }
 
     void assign(size_type count, const value_type& value)
@@ -108,7 +271,8 @@ public:
         pre.clear();
         suf.assign(count, value);
     }
-    template<class InputIt>
+    template<class InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
     void assign(InputIt first, InputIt last)
     {
         pre.clear();
@@ -174,41 +338,37 @@ public:
     }
 
     iterator begin() { return iterator(-static_cast<difference_type>(pre.size()), this); }
-    const_iterator begin() const { return iterator(-static_cast<difference_type>(pre.size()), this); }
+    const_iterator begin() const { return cbegin(); }
     const_iterator cbegin() const { return const_iterator(-static_cast<difference_type>(pre.size()), this); }
     iterator end() { return iterator(suf.size(), this); }
-    const_iterator end() const { return iterator(suf.size(), this); }
+    const_iterator end() const { return cend(); }
     const_iterator cend() const { return const_iterator(suf.size(), this); }
-    reverse_iterator rbegin()
-    { 
-        return reverse_iterator(static_cast<difference_type>(suf.size()) - 1, this); 
-    }
-    const_reverse_iterator rbegin() const
-    { 
-        return reverse_iterator(static_cast<difference_type>(suf.size()) - 1, this); 
-    }
-    const_reverse_iterator crbegin() const
-    { 
-        return const_reverse_iterator(static_cast<difference_type>(suf.size()) - 1, this); 
-    }
-    reverse_iterator rend() 
-    { 
-        return reverse_iterator(-static_cast<difference_type>(pre.size()) - 1, this); 
-    }
-    const_reverse_iterator rend() const
-    { 
-        return reverse_iterator(-static_cast<difference_type>(pre.size()) - 1, this); 
-    }
-    const_reverse_iterator crend() const 
-    { 
-        return const_reverse_iterator(-static_cast<difference_type>(pre.size()) - 1, this); 
-    }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return crbegin(); }
+    const_reverse_iterator crbegin() const { return const_reverse_iterator(cend()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return crend(); }
+    const_reverse_iterator crend() const { return const_reverse_iterator(cbegin()); }
 
     bool empty() const
     {
         return pre.empty() && suf.empty();
     }
 
+    // The elements live in two contiguous blocks. The front one holds the
+    // first elements in REVERSE order, i.e. its first element is the last of
+    // them. The back one holds the remaining elements in order.
+    Span<T> reversed_front_span() noexcept { return Span<T>(pre.data(), pre.size()); }
+    Span<const T> reversed_front_span() const noexcept
+    {
+        return Span<const T>(pre.data(), pre.size());
+    }
+    Span<T> back_span() noexcept { return Span<T>(suf.data(), suf.size()); }
+    Span<const T> back_span() const noexcept
+    {
+        return Span<const T>(suf.data(), suf.size());
+    }
+
     size_type max_size() const { return pre.max_size(); }
 
     void shrink_to_fit() 
@@ -232,7 +392,7 @@ public:
         else {
             suf.insert(suf.cbegin() + dis, val);
         }
-        return pos;
+        return inserted(dis, 1);
     }
     iterator insert(const_iterator pos, value_type&& val) 
     {
@@ -243,47 +403,47 @@ public:
         else {
             suf.insert(suf.cbegin() + dis, std::move(val));
         }
-        return pos;
+        return inserted(dis, 1);
     }
     
     iterator insert(const_iterator pos, size_type count, const value_type& val) 
     {
         difference_type dis = pos.cur;
         if (dis < 0) {
-            Vec temp(count, val);
-            std::reverse(temp.begin(), temp.end());
-            pre.insert(pre.cbegin() - dis, temp.begin(), temp.end()); 
+            pre.insert(pre.cbegin() - dis, count, val);
         }
         else {
             suf.insert(suf.cbegin() + dis, count, val);
         }
-        return pos;
+        return inserted(dis, count);
     }
-    template<class InputIt>
+    template<class InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
     iterator insert(const_iterator pos, InputIt first, InputIt last) 
     {
         difference_type dis = pos.cur;
+        size_type old_size = size();
         if (dis < 0) {
-            Vec temp(first, last);
-            std::reverse(temp.begin(), temp.end());
-            pre.insert(pre.cbegin() - dis, temp.begin(), temp.end()); 
+            insert_reversed(pre.cbegin() - dis, first, last,
+                typename std::iterator_traits<InputIt>::iterator_category());
         }
         else {
             suf.insert(suf.cbegin() + dis, first, last);
         }
-        return pos;
+        return inserted(dis, size() - old_size);
     }
     iterator insert(const_iterator pos, std::initializer_list<value_type> ilist) 
     {
         difference_type dis = pos.cur;
+        size_type old_size = size();
         if (dis < 0) {
-            std::reverse(ilist.begin(), ilist.end());
-            pre.insert(pre.cbegin() - dis, ilist); 
+            pre.insert(pre.cbegin() - dis, std::reverse_iterator<const T*>(ilist.end()),
+                       std::reverse_iterator<const T*>(ilist.begin()));
         }
         else {
             suf.insert(suf.cbegin() + dis, ilist);
         }
-        return pos;
+        return inserted(dis, size() - old_size);
     }
 
     template<class... Args>
@@ -291,12 +451,12 @@ public:
     {
         difference_type dis = pos.cur;
         if (dis < 0) {
-            pre.emplace(pre.cbegin() - dis, args...); ///
+            pre.emplace(pre.cbegin() - dis, std::forward<Args>(args)...); ///
         }
         else {
-            suf.emplace(suf.cbegin() + dis, args...);
+            suf.emplace(suf.cbegin() + dis, std::forward<Args>(args)...);
         }
-        return pos;
+        return inserted(dis, 1);
     }
 
     iterator erase(const_iterator pos) 
@@ -306,7 +466,7 @@ public:
             pre.erase(pre.cbegin() - dis - 1); ///
         }
         else suf.erase(suf.cbegin() + dis);
-        return pos;
+        return iterator(dis < 0 ? dis + 1 : dis, this);
     }
 
     iterator erase(const_iterator first, const_iterator last)
@@ -315,14 +475,16 @@ public:
         if (from < 0 && to >= 0) {
             pre.erase(pre.cbegin(), pre.cbegin() - from);
             suf.erase(suf.cbegin(), suf.cbegin() + to);
+            return iterator(0, this);
         }
         else if (from >= 0) {
             suf.erase(suf.cbegin() + from, suf.cbegin() + to);
+            return iterator(from, this);
         }
         else { ///
             pre.erase(pre.cbegin() - to, pre.cbegin() - from);
+            return iterator(to, this);
         }
-        return last;
     }
 
 #ifdef USE_EXTRA_ACC_DEQUE_OPT
@@ -345,10 +507,10 @@ public:
         difference_type dis = static_cast<difference_type>(pos) 
                             - static_cast<difference_type>(pre.size());
         if (dis < 0) {
-            pre.emplace(pre.cbegin() - dis, args...); ///
+            pre.emplace(pre.cbegin() - dis, std::forward<Args>(args)...); ///
         }
         else {
-            suf.emplace(suf.cbegin() + dis, args...);
+            suf.emplace(suf.cbegin() + dis, std::forward<Args>(args)...);
         }
     }
 
@@ -367,7 +529,7 @@ public:
     {
         difference_type from = static_cast<difference_type>(first) 
                              - static_cast<difference_type>(pre.size());
-        difference_type to = static_cast<difference_type>(to) 
+        difference_type to = static_cast<difference_type>(last) 
                         - static_cast<difference_type>(pre.size());
         if (from < 0 && to >= 0) {
             pre.erase(pre.cbegin(), pre.cbegin() - from);
@@ -386,24 +548,28 @@ public:
     void push_back(const value_type& val) 
     {
         suf.push_back(val);
+        RebuildPolicy::pushed_back();
     }
     void push_back(value_type&& val) 
     {
         suf.push_back(std::move(val));
+        RebuildPolicy::pushed_back();
     }
 
 #if __cplusplus >= 201703L
     template<class... Args>
     reference emplace_back(Args&&... args) 
     {
-        return suf.emplace_back(args...);
+        RebuildPolicy::pushed_back();
+        return suf.emplace_back(std::forward<Args>(args)...);
     }
 #else
 
     template<class... Args>
     void emplace_back(Args&&... args) 
     {
-        suf.emplace_back(args...);
+        suf.emplace_back(std::forward<Args>(args)...);
+        RebuildPolicy::pushed_back();
     }
 
 #endif
@@ -417,24 +583,28 @@ public:
     void push_front(const value_type& val) 
     {
         pre.push_back(val);
+        RebuildPolicy::pushed_front();
     }
     void push_front(value_type&& val) 
     {
         pre.push_back(std::move(val));
+        RebuildPolicy::pushed_front();
     }
 
 #if __cplusplus >= 201703L
     template<class... Args>
     reference emplace_front(Args&&... args) 
     {
-        return pre.emplace_back(args...);
+        RebuildPolicy::pushed_front();
+        return pre.emplace_back(std::forward<Args>(args)...);
     }
 #else
 
     template<class... Args>
     void emplace_front(Args&&... args) 
     {
-        pre.emplace_back(args...);
+        pre.emplace_back(std::forward<Args>(args)...);
+        RebuildPolicy::pushed_front();
     }
 
 #endif
@@ -445,9 +615,73 @@ public:
         pre.pop_back();
     }
 
+    // Bulk insertion at either end. A forward range is written straight into
+    // the block of that end, with at most one allocation; an rvalue range has
+    // its elements moved.
+    template<class Range>
+    void append_range(Range&& rg)
+    {
+        using std::begin;
+        using std::end;
+        append(range_iterator<Range>(begin(rg)), range_iterator<Range>(end(rg)));
+    }
+    template<class Range>
+    void prepend_range(Range&& rg)
+    {
+        using std::begin;
+        using std::end;
+        prepend(range_iterator<Range>(begin(rg)), range_iterator<Range>(end(rg)));
+    }
+
+    template<class InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    void append(InputIt first, InputIt last)
+    {
+        suf.insert(suf.end(), first, last);
+    }
+    template<class InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    void prepend(InputIt first, InputIt last)
+    {
+        insert_reversed(pre.cend(), first, last,
+            typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    void append(const Self& other)
+    {
+        if (&other == this) {
+            append(Self(other));
+            return;
+        }
+        grow_back(other.size());
+        append(other.pre.rbegin(), other.pre.rend());
+        append(other.suf.begin(), other.suf.end());
+    }
+    void append(Self&& other)
+    {
+        if (&other == this) {
+            append(static_cast<const Self&>(other));
+            return;
+        }
+        if (empty()) {
+            swap(other);
+            return;
+        }
+        grow_back(other.size());
+        append(std::make_move_iterator(other.pre.rbegin()),
+               std::make_move_iterator(other.pre.rend()));
+        append(std::make_move_iterator(other.suf.begin()),
+               std::make_move_iterator(other.suf.end()));
+        other.clear();
+    }
+
+    // The rebuild policy goes along with the elements, as its state
+    // describes them.
     void swap(Self& t) {
+        using std::swap;
         pre.swap(t.pre);
         suf.swap(t.suf);
+        swap(policy(), t.policy());
     }
 
     void resize(size_type new_size)
@@ -493,15 +727,62 @@ private:
     Vec pre;
     Vec suf;
 
+    RebuildPolicy& policy() noexcept { return *this; }
+    const RebuildPolicy& policy() const noexcept { return *this; }
+
+    // Room for `count` more elements at the back with one allocation, keeping
+    // the geometric growth so repeated small appends stay linear.
+    void grow_back(size_type count)
+    {
+        size_type need = suf.size() + count;
+        if (need > suf.capacity()) suf.reserve(std::max(need, 2 * suf.capacity()));
+    }
+
     pointer at_unsafe(difference_type pos)
     {
-        if (pos < 0) return (pre.begin() - pos - 1);
-        return (suf.begin() + pos);
+        if (pos < 0) return (pre.data() - pos - 1);
+        return (suf.data() + pos);
     }
     const_pointer at_const_unsafe(difference_type pos) const
     {
-        if (pos < 0) return (pre.cbegin() - pos - 1);
-        return (suf.cbegin() + pos);
+        if (pos < 0) return (pre.data() - pos - 1);
+        return (suf.data() + pos);
+    }
+
+    template<class Range, class It>
+    using range_iterator_t = typename std::conditional<
+        std::is_lvalue_reference<Range>::value, It, std::move_iterator<It>>::type;
+
+    template<class Range, class It>
+    static range_iterator_t<Range, It> range_iterator(It it)
+    {
+        return range_iterator_t<Range, It>(it);
+    }
+
+    // Inserts [first, last) into pre in reverse order, so that the elements
+    // keep their order in the deque.
+    template<class BidirIt>
+    void insert_reversed(typename Vec::const_iterator pos, BidirIt first, BidirIt last,
+                         std::bidirectional_iterator_tag)
+    {
+        pre.insert(pos, std::reverse_iterator<BidirIt>(last),
+                   std::reverse_iterator<BidirIt>(first));
+    }
+    template<class InputIt>
+    void insert_reversed(typename Vec::const_iterator pos, InputIt first, InputIt last,
+                         std::input_iterator_tag)
+    {
+        size_type at = pos - pre.cbegin(), old_size = pre.size();
+        pre.insert(pre.end(), first, last);
+        std::reverse(pre.begin() + old_size, pre.end());
+        std::rotate(pre.begin() + at, pre.begin() + old_size, pre.end());
+    }
+
+    // Iterator to the first of `count` elements just inserted before the
+    // position `dis`. Inserting into pre shifts them to the left of `dis`.
+    iterator inserted(difference_type dis, size_type count)
+    {
+        return iterator(dis < 0 ? dis - static_cast<difference_type>(count) : dis, this);
     }
 
     void range_check(size_type pos) const ///
@@ -515,28 +796,31 @@ private:
         }
     }
 
+    static void relocate(Vec& from, Vec& to, size_type count)
+    {
+        relocate_reversed(from, to, count);
+    }
+
     void rebuild()
     {
-        if (pre.empty()) {
-            size_type mid = suf.size() / 2;
-            pre = Vec(suf.rbegin() + mid, suf.rend());
-            suf = Vec(suf.end() - mid, suf.end());
-        }
-        else {
-            size_type mid = pre.size() / 2;
-            suf = Vec(pre.rbegin() + mid, pre.rend());
-            pre = Vec(pre.end() - mid, pre.end());
-        }
+        if (pre.empty()) relocate(suf, pre, split(suf.size(), true));
+        else relocate(pre, suf, split(pre.size(), false));
+    }
+
+    size_type split(size_type n, bool to_front)
+    {
+        size_type k = RebuildPolicy::split(n, to_front);
+        return k < 1 ? 1 : (k > n ? n : k);
     }
 
 };
 
 #ifndef __TEMPL_DECLARE
-#define __TEMPL_DECLARE template<typename T, typename Container>
+#define __TEMPL_DECLARE template<typename T, typename Container, typename RebuildPolicy>
 #endif
 
 #ifndef __TEMPL_DQ
-#define __TEMPL_DQ Deque<T, Container>
+#define __TEMPL_DQ Deque<T, Container, RebuildPolicy>
 #endif 
 
 __TEMPL_DECLARE void swap(__TEMPL_DQ& lhs, __TEMPL_DQ& rhs) 
@@ -544,13 +828,104 @@ __TEMPL_DECLARE void swap(__TEMPL_DQ& lhs, __TEMPL_DQ& rhs)
     lhs.swap(rhs);
 }
 
-__TEMPL_DECLARE bool operator==(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
+// Whether `==` on T compares exactly the bytes of the objects, so ranges of
+// T can be compared with memcmp. True for integers, enums and pointers, not
+// for floating point (0.0 == -0.0, NaN != NaN). Specialize it for types
+// without padding whose `==` is memberwise over such types.
+template<typename T>
+struct is_trivially_comparable : std::integral_constant<bool,
+    std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value> { };
+
+// Comparison of two Deques walks them piece by piece: where both positions
+// are in the front blocks, where only one is, and where both are in the back
+// blocks. Within a piece both sides are contiguous, so the elements are
+// compared in blocks: with memcmp for trivially comparable types, with a
+// branch-free loop the compiler vectorizes for other arithmetic types, and
+// one by one otherwise.
+namespace segments
+{
+
+// Physical address of the first of the `n` elements starting at `it`, for
+// plain pointers and for the reversed front blocks.
+template<typename T>
+const T* lowest(const T* it, std::size_t) { return it; }
+template<typename T>
+const T* lowest(std::reverse_iterator<const T*> it, std::size_t n) { return (it + n).base(); }
+
+template<typename ItA, typename ItB>
+bool block_differs(ItA a, ItB b, std::size_t n, std::true_type)
+{
+    typedef typename std::iterator_traits<ItA>::value_type T;
+    return std::memcmp(lowest(a, n), lowest(b, n), n * sizeof(T)) != 0;
+}
+
+template<typename ItA, typename ItB>
+bool block_differs(ItA a, ItB b, std::size_t n, std::false_type)
+{
+    bool diff = false;
+    for (std::size_t i = 0; i < n; ++i) diff |= !(a[i] == b[i]);
+    return diff;
+}
+
+// The first i < n with !(a[i] == b[i]), or n.
+template<typename ItA, typename ItB>
+std::size_t mismatch(ItA a, ItB b, std::size_t n)
 {
-    if (lhs.size() != rhs.size()) return false;
-    for (size_t i = 0, len = lhs.size(); i < len; i++) {
-        if (lhs[i] != rhs[i]) return false;
+    typedef typename std::iterator_traits<ItA>::value_type T;
+    // memcmp needs both sides in the same direction.
+    typedef std::integral_constant<bool, is_trivially_comparable<T>::value
+        && std::is_same<ItA, ItB>::value> Bytes;
+    std::size_t i = 0;
+    if (Bytes::value || std::is_arithmetic<T>::value) {
+        const std::size_t bytes = Bytes::value ? 256 : 64;
+        const std::size_t block = sizeof(T) < bytes ? bytes / sizeof(T) : 1;
+        for (; n - i >= block; i += block) {
+            if (block_differs(a + i, b + i, block, Bytes())) break;
+        }
     }
-    return true;
+    for (; i < n; ++i) {
+        if (!(a[i] == b[i])) return i;
+    }
+    return n;
+}
+
+}
+
+// The first position where the deques differ, or the size of the shorter.
+__TEMPL_DECLARE std::size_t mismatch(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
+{
+    typedef std::reverse_iterator<const T*> Rev;
+    Span<const T> lf = lhs.reversed_front_span(), lb = lhs.back_span();
+    Span<const T> rf = rhs.reversed_front_span(), rb = rhs.back_span();
+    std::size_t len = std::min(lhs.size(), rhs.size());
+    std::size_t lo = std::min(std::min(lf.size(), rf.size()), len);
+    std::size_t hi = std::min(std::max(lf.size(), rf.size()), len);
+    std::size_t i = segments::mismatch(Rev(lf.end()), Rev(rf.end()), lo);
+    if (i < lo) return i;
+    if (lf.size() > rf.size()) {
+        i = segments::mismatch(Rev(lf.end()) + lo, rb.begin(), hi - lo);
+    }
+    else i = segments::mismatch(lb.begin(), Rev(rf.end()) + lo, hi - lo);
+    if (i < hi - lo || hi == len) return lo + i;
+    return hi + segments::mismatch(lb.begin() + (hi - lf.size()), rb.begin() + (hi - rf.size()),
+                                   len - hi);
+}
+
+// Negative, zero or positive as lhs is lexicographically less than, equal
+// to or greater than rhs. Elements are tested with == and then <.
+__TEMPL_DECLARE int three_way(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
+{
+    std::size_t i = mismatch(lhs, rhs);
+    if (i < lhs.size() && i < rhs.size()) {
+        if (lhs[i] < rhs[i]) return -1;
+        return rhs[i] < lhs[i] ? 1 : 0;
+    }
+    return lhs.size() < rhs.size() ? -1 : (lhs.size() > rhs.size() ? 1 : 0);
+}
+
+__TEMPL_DECLARE bool operator==(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
+{
+    return lhs.size() == rhs.size() && mismatch(lhs, rhs) == lhs.size();
 }
 
 __TEMPL_DECLARE bool operator!=(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
@@ -560,48 +935,39 @@ __TEMPL_DECLARE bool operator!=(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
 
 __TEMPL_DECLARE bool operator<(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
 {
-    size_t len = min(lhs.size(), rhs.size());
-    for (size_t i = 0; i < len; i++) {
-        if (lhs[i] != rhs[i]) {
-            return lhs[i] < rhs[i];
-        }
-    }
-    return lhs.size() < rhs.size();
+    return three_way(lhs, rhs) < 0;
 }
 
 __TEMPL_DECLARE bool operator>(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
 {
-    size_t len = min(lhs.size(), rhs.size());
-    for (size_t i = 0; i < len; i++) {
-        if (lhs[i] != rhs[i]) {
-            return lhs[i] > rhs[i];
-        }
-    }
-    return lhs.size() > rhs.size();
+    return three_way(lhs, rhs) > 0;
 }
 
 __TEMPL_DECLARE bool operator<=(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
 {
-    size_t len = min(lhs.size(), rhs.size());
-    for (size_t i = 0; i < len; i++) {
-        if (lhs[i] != rhs[i]) {
-            return lhs[i] < rhs[i];
-        }
-    }
-    return lhs.size() <= rhs.size();
+    return three_way(lhs, rhs) <= 0;
 }
 
 __TEMPL_DECLARE bool operator>=(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs)
 {
-    size_t len = min(lhs.size(), rhs.size());
-    for (size_t i = 0; i < len; i++) {
-        if (lhs[i] != rhs[i]) {
-            return lhs[i] > rhs[i];
-        }
-    }
-    return lhs.size() >= rhs.size();
+    return three_way(lhs, rhs) >= 0;
 }
 
+// Hashes the elements in order with std::hash, so equal deques hash equally
+// whatever their layout.
+__TEMPL_DECLARE std::size_t hash_value(const __TEMPL_DQ& x)
+{
+    std::hash<T> h;
+    std::uint64_t res = x.size();
+    auto step = [&](const T& v) {
+        res = ((res << 5) | (res >> 59)) ^ std::uint64_t(h(v));
+        res *= 0x9e3779b97f4a7c15ull;
+    };
+    Span<const T> f = x.reversed_front_span(), b = x.back_span();
+    for (const T* p = f.end(); p != f.begin(); ) step(*--p);
+    for (const T& v: b) step(v);
+    return std::size_t(res ^ (res >> 32));
+}
 
 #ifdef USE_EXTRA_ACC_DEQUE_OPT
 
@@ -618,23 +984,31 @@ __TEMPL_DECLARE std::ostream& operator<<(std::ostream& out, const __TEMPL_DQ& x)
 
 __TEMPL_DECLARE __TEMPL_DQ& operator+=(__TEMPL_DQ& x, const __TEMPL_DQ& y)
 {
-    size_t len_y = y.size();
-    for (size_t i = 0; i < len_y; i++) {
-        x.emplace_back(y[i]);
-    }
+    x.append(y);
+    return x;
+}
+
+__TEMPL_DECLARE __TEMPL_DQ& operator+=(__TEMPL_DQ& x, __TEMPL_DQ&& y)
+{
+    x.append(std::move(y));
     return x;
 }
 
 __TEMPL_DECLARE __TEMPL_DQ operator+(const __TEMPL_DQ& x, const __TEMPL_DQ& y)
 {
-    size_t len_y = y.size();
-    __TEMPL_DQ z(x);
-    for (size_t i = 0; i < len_y; i++) {
-        z.emplace_back(y[i]);
-    }
+    __TEMPL_DQ z(x.get_allocator());
+    z.reserve_back(x.size() + y.size());
+    z.append(x);
+    z.append(y);
     return z;
 }
 
+__TEMPL_DECLARE __TEMPL_DQ operator+(__TEMPL_DQ&& x, const __TEMPL_DQ& y)
+{
+    x.append(y);
+    return std::move(x);
+}
+
 #endif
 
 #else
@@ -645,4 +1019,22 @@ static_assert(false, "Require C++11 or later for acc::deque.");
 
 }
 
+#if __cplusplus >= 201103L
+
+namespace std
+{
+
+template<typename T, typename Container, typename RebuildPolicy>
+struct hash<acc::Deque<T, Container, RebuildPolicy>>
+{
+    std::size_t operator()(const acc::Deque<T, Container, RebuildPolicy>& x) const
+    {
+        return acc::hash_value(x);
+    }
+};
+
+}
+
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+// Algorithms over acc::Deque that work on its two contiguous blocks.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+// The std algorithms work on a Deque through its iterators, which decide on
+// every element which block it lives in. The overloads here take the whole
+// deque and run the std algorithm on each block through plain pointers
+// instead. The front block is walked backwards, see reversed_front_span().
+
+#ifndef _ACC_DEQUE_ALGORITHM
+#define _ACC_DEQUE_ALGORITHM
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include "Deque.hpp"
+
+namespace acc
+{
+
+#ifndef __TEMPL_DECLARE
+#define __TEMPL_DECLARE template<typename T, typename Container, typename RebuildPolicy>
+#endif
+
+#ifndef __TEMPL_DQ
+#define __TEMPL_DQ Deque<T, Container, RebuildPolicy>
+#endif
+
+template<typename T, typename Container, typename RebuildPolicy, typename OutputIt>
+OutputIt copy(const __TEMPL_DQ& dq, OutputIt out)
+{
+    Span<const T> f = dq.reversed_front_span(), b = dq.back_span();
+    out = std::reverse_copy(f.begin(), f.end(), out);
+    return std::copy(b.begin(), b.end(), out);
+}
+
+__TEMPL_DECLARE void fill(__TEMPL_DQ& dq, const T& value)
+{
+    Span<T> f = dq.reversed_front_span(), b = dq.back_span();
+    std::fill(f.begin(), f.end(), value);
+    std::fill(b.begin(), b.end(), value);
+}
+
+template<typename T, typename Container, typename RebuildPolicy, typename U>
+typename __TEMPL_DQ::iterator find(__TEMPL_DQ& dq, const U& value)
+{
+    Span<T> f = dq.reversed_front_span(), b = dq.back_span();
+    auto it = std::find(f.rbegin(), f.rend(), value);
+    if (it != f.rend()) return dq.begin() + (it - f.rbegin());
+    return dq.begin() + (f.size() + (std::find(b.begin(), b.end(), value) - b.begin()));
+}
+template<typename T, typename Container, typename RebuildPolicy, typename U>
+typename __TEMPL_DQ::const_iterator find(const __TEMPL_DQ& dq, const U& value)
+{
+    Span<const T> f = dq.reversed_front_span(), b = dq.back_span();
+    auto it = std::find(f.rbegin(), f.rend(), value);
+    if (it != f.rend()) return dq.cbegin() + (it - f.rbegin());
+    return dq.cbegin() + (f.size() + (std::find(b.begin(), b.end(), value) - b.begin()));
+}
+
+template<typename T, typename Container, typename RebuildPolicy, typename U>
+std::size_t count(const __TEMPL_DQ& dq, const U& value)
+{
+    Span<const T> f = dq.reversed_front_span(), b = dq.back_span();
+    return std::count(f.begin(), f.end(), value) + std::count(b.begin(), b.end(), value);
+}
+
+template<typename T, typename Container, typename RebuildPolicy, typename Acc,
+         typename BinaryOp = std::plus<Acc>>
+Acc accumulate(const __TEMPL_DQ& dq, Acc init, BinaryOp op = BinaryOp())
+{
+    Span<const T> f = dq.reversed_front_span(), b = dq.back_span();
+    init = std::accumulate(f.rbegin(), f.rend(), std::move(init), op);
+    return std::accumulate(b.begin(), b.end(), std::move(init), op);
+}
+
+template<typename T, typename Container, typename RebuildPolicy, typename U,
+         typename Compare = std::less<T>>
+typename __TEMPL_DQ::iterator lower_bound(__TEMPL_DQ& dq, const U& value,
+                                          Compare comp = Compare())
+{
+    Span<T> f = dq.reversed_front_span(), b = dq.back_span();
+    // f[0] is the last element of the front block in sequence order.
+    if (!f.empty() && !comp(f[0], value)) {
+        return dq.begin() + (std::lower_bound(f.rbegin(), f.rend(), value, comp) - f.rbegin());
+    }
+    return dq.begin() + (f.size() + (std::lower_bound(b.begin(), b.end(), value, comp)
+                                     - b.begin()));
+}
+
+// Compares the sequences piece by piece: the parts where both are in their
+// front blocks, where one has reached its back block, and where both have.
+template<typename T, typename Container, typename RebuildPolicy,
+         typename BinaryPred = std::equal_to<T>>
+bool equal(const __TEMPL_DQ& lhs, const __TEMPL_DQ& rhs, BinaryPred pred = BinaryPred())
+{
+    if (lhs.size() != rhs.size()) return false;
+    Span<const T> lf = lhs.reversed_front_span(), lb = lhs.back_span();
+    Span<const T> rf = rhs.reversed_front_span(), rb = rhs.back_span();
+    std::size_t lo = std::min(lf.size(), rf.size()), hi = std::max(lf.size(), rf.size());
+    if (!std::equal(lf.end() - lo, lf.end(), rf.end() - lo, pred)) return false;
+    if (lf.size() > rf.size()) {
+        if (!std::equal(lf.rbegin() + lo, lf.rend(), rb.begin(), pred)) return false;
+    }
+    else if (!std::equal(lb.begin(), lb.begin() + (hi - lo), rf.rbegin() + lo, pred)) {
+        return false;
+    }
+    return std::equal(lb.begin() + (hi - lf.size()), lb.end(), rb.begin() + (hi - rf.size()), pred);
+}
+
+// Sorts each block through plain pointers, the front one in reverse order,
+// then merges the two sorted halves.
+template<typename T, typename Container, typename RebuildPolicy,
+         typename Compare = std::less<T>>
+void sort(__TEMPL_DQ& dq, Compare comp = Compare())
+{
+    Span<T> f = dq.reversed_front_span(), b = dq.back_span();
+    std::sort(f.begin(), f.end(), [&comp](const T& x, const T& y) { return comp(y, x); });
+    std::sort(b.begin(), b.end(), comp);
+    if (!f.empty() && !b.empty() && comp(b[0], f[0])) {
+        std::inplace_merge(dq.begin(), dq.begin() + f.size(), dq.end(), comp);
+    }
+}
+
+}
+
+#endif
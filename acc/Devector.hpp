@@ -0,0 +1,579 @@
+// A vector with free space at both ends.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <initializer_list>
+
+#include "Span.hpp"
+
+#ifndef _ACC_DEVECTOR
+#define _ACC_DEVECTOR
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// The elements are kept contiguous in [first, last) inside one buffer
+// [storage, storage + cap), with free space on both sides. A push at an end
+// that has no room left either moves the elements back to the middle of the
+// buffer, when at most half of it would be used, or moves them to the middle
+// of a buffer twice as large. Iterators are plain pointers.
+template<typename T, typename Alloc = std::allocator<T>>
+class Devector
+{
+
+private:
+
+    typedef Devector<T, Alloc> Self;
+    typedef std::allocator_traits<Alloc> AllocTraits;
+
+public:
+
+    typedef T                                           value_type;
+    typedef Alloc                                       allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef typename AllocTraits::pointer               pointer;
+    typedef typename AllocTraits::const_pointer         const_pointer;
+    typedef pointer                                     iterator;
+    typedef const_pointer                               const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    explicit Devector(const allocator_type& alloc): alloc(alloc) { }
+    Devector(): Devector(allocator_type()) { }
+    Devector(size_type count, const value_type& value,
+        const allocator_type& alloc = allocator_type()): Devector(alloc)
+    {
+        assign(count, value);
+    }
+    explicit Devector(size_type count,
+        const allocator_type& alloc = allocator_type()): Devector(alloc)
+    {
+        resize(count);
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    Devector(InputIt first, InputIt last,
+        const allocator_type& alloc = allocator_type()): Devector(alloc)
+    {
+        append(first, last);
+    }
+    Devector(const Self& other): Devector(other.begin(), other.end(),
+        AllocTraits::select_on_container_copy_construction(other.alloc)) { }
+    Devector(Self&& other) noexcept: alloc(std::move(other.alloc))
+    {
+        steal(other);
+    }
+    Devector(std::initializer_list<value_type> init,
+        const allocator_type& alloc = allocator_type())
+        : Devector(init.begin(), init.end(), alloc) { }
+
+    ~Devector()
+    {
+        destroy(first, last);
+        deallocate();
+    }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept
+    {
+        if (this != &other) {
+            destroy(first, last);
+            deallocate();
+            alloc = std::move(other.alloc);
+            steal(other);
+        }
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        append(first, last);
+    }
+    void assign(size_type count, const value_type& value)
+    {
+        clear();
+        reserve_back(count);
+        while (count--) emplace_back(value);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc; }
+
+    reference operator[](size_type pos) { return first[pos]; }
+    const_reference operator[](size_type pos) const { return first[pos]; }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return first[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return first[pos];
+    }
+
+    reference front() { return *first; }
+    const_reference front() const { return *first; }
+    reference back() { return *(last - 1); }
+    const_reference back() const { return *(last - 1); }
+
+    pointer data() noexcept { return first; }
+    const_pointer data() const noexcept { return first; }
+
+    // The whole sequence as one contiguous span.
+    Span<T> span() noexcept { return Span<T>(first, size()); }
+    Span<const T> span() const noexcept { return Span<const T>(first, size()); }
+
+    iterator begin() noexcept { return first; }
+    const_iterator begin() const noexcept { return first; }
+    const_iterator cbegin() const noexcept { return first; }
+    iterator end() noexcept { return last; }
+    const_iterator end() const noexcept { return last; }
+    const_iterator cend() const noexcept { return last; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    size_type size() const noexcept { return size_type(last - first); }
+    bool empty() const noexcept { return first == last; }
+    size_type max_size() const noexcept { return AllocTraits::max_size(alloc); }
+    size_type capacity() const noexcept { return cap; }
+
+    // Free slots before the first and after the last element.
+    size_type front_free_capacity() const noexcept { return size_type(first - storage); }
+    size_type back_free_capacity() const noexcept { return size_type(storage + cap - last); }
+
+    // Elements that fit without reallocation when only pushing at the front
+    // (or at the back).
+    size_type front_capacity() const noexcept { return size_type(last - storage); }
+    size_type back_capacity() const noexcept { return size_type(storage + cap - first); }
+
+    void reserve(size_type new_cap) { reserve_back(new_cap); }
+    void reserve_front(size_type new_cap)
+    {
+        if (new_cap > front_capacity()) {
+            reallocate(new_cap + back_free_capacity(), new_cap - size());
+        }
+    }
+    void reserve_back(size_type new_cap)
+    {
+        if (new_cap > back_capacity()) {
+            reallocate(new_cap + front_free_capacity(), front_free_capacity());
+        }
+    }
+    void shrink_to_fit()
+    {
+        if (empty()) deallocate();
+        else if (size() < cap) reallocate(size(), 0);
+    }
+
+    void clear() noexcept
+    {
+        destroy(first, last);
+        first = last = storage + cap / 2;
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+    void push_front(const value_type& val) { emplace_front(val); }
+    void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (last == storage + cap) {
+            // args may refer to an element, which grow() moves.
+            value_type tmp(std::forward<Args>(args)...);
+            grow(0, 1);
+            construct(last, std::move(tmp));
+        }
+        else construct(last, std::forward<Args>(args)...);
+        return *last++;
+    }
+
+    template<class... Args>
+    reference emplace_front(Args&&... args)
+    {
+        if (first == storage) {
+            value_type tmp(std::forward<Args>(args)...);
+            grow(1, 0);
+            construct(first - 1, std::move(tmp));
+        }
+        else construct(first - 1, std::forward<Args>(args)...);
+        return *--first;
+    }
+
+    void pop_back()
+    {
+        AllocTraits::destroy(alloc, std::addressof(*--last));
+        if (first == last) first = last = storage + cap / 2;
+    }
+
+    void pop_front()
+    {
+        AllocTraits::destroy(alloc, std::addressof(*first++));
+        if (first == last) first = last = storage + cap / 2;
+    }
+
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void append(InputIt from, InputIt to)
+    {
+        append(from, to, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    // Inserts [from, to) before the first element, keeping its order.
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void prepend(InputIt from, InputIt to)
+    {
+        prepend(from, to, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    // Insertions and erasures move the elements on the shorter side of pos.
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type off = pos - cbegin();
+        if (off < size() / 2) {
+            emplace_front(std::forward<Args>(args)...);
+            std::rotate(first, first + 1, first + off + 1);
+        }
+        else {
+            emplace_back(std::forward<Args>(args)...);
+            std::rotate(first + off, last - 1, last);
+        }
+        return first + off;
+    }
+
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_type count, const value_type& value)
+    {
+        value_type tmp(value);
+        size_type off = pos - cbegin();
+        if (off < size() / 2) {
+            if (count > front_free_capacity()) grow(count, 0);
+            for (size_type i = 0; i < count; ++i) emplace_front(tmp);
+            std::rotate(first, first + count, first + count + off);
+        }
+        else {
+            if (count > back_free_capacity()) grow(0, count);
+            for (size_type i = 0; i < count; ++i) emplace_back(tmp);
+            std::rotate(first + off, last - count, last);
+        }
+        return first + off;
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt from, InputIt to)
+    {
+        size_type off = pos - cbegin(), old = size();
+        if (off < old / 2) {
+            prepend(from, to);
+            size_type count = size() - old;
+            std::rotate(first, first + count, first + count + off);
+        }
+        else {
+            append(from, to);
+            std::rotate(first + off, first + old, last);
+        }
+        return first + off;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator from, const_iterator to)
+    {
+        pointer f = first + (from - cbegin()), t = first + (to - cbegin());
+        if (f == t) return f;
+        if (f - first < last - t) {
+            pointer nf = std::move_backward(first, f, t);
+            destroy(first, nf);
+            first = nf;
+        }
+        else {
+            pointer nl = std::move(t, last, f);
+            destroy(nl, last);
+            last = nl;
+            t = f;
+        }
+        if (first == last) first = last = t = storage + cap / 2;
+        return t;
+    }
+
+    void resize(size_type count)
+    {
+        if (count <= size()) destroy_back(count);
+        else {
+            if (count - size() > back_free_capacity()) grow(0, count - size());
+            while (size() < count) emplace_back();
+        }
+    }
+    void resize(size_type count, const value_type& value)
+    {
+        if (count <= size()) destroy_back(count);
+        else {
+            value_type tmp(value);
+            if (count - size() > back_free_capacity()) grow(0, count - size());
+            while (size() < count) emplace_back(tmp);
+        }
+    }
+
+    void swap(Self& other) noexcept
+    {
+        using std::swap;
+        swap(alloc, other.alloc);
+        swap(storage, other.storage);
+        swap(cap, other.cap);
+        swap(first, other.first);
+        swap(last, other.last);
+    }
+
+private:
+
+    allocator_type alloc;
+    pointer storage = pointer();
+    size_type cap = 0;
+    pointer first = pointer();
+    pointer last = pointer();
+
+    template<class... Args>
+    void construct(pointer p, Args&&... args)
+    {
+        AllocTraits::construct(alloc, std::addressof(*p), std::forward<Args>(args)...);
+    }
+
+    void destroy(pointer from, pointer to) noexcept
+    {
+        for (; from != to; ++from) AllocTraits::destroy(alloc, std::addressof(*from));
+    }
+
+    void destroy_back(size_type count) noexcept
+    {
+        destroy(first + count, last);
+        last = first + count;
+        if (first == last) first = last = storage + cap / 2;
+    }
+
+    void deallocate() noexcept
+    {
+        if (storage) AllocTraits::deallocate(alloc, storage, cap);
+        storage = first = last = pointer(), cap = 0;
+    }
+
+    void steal(Self& other) noexcept
+    {
+        storage = other.storage, cap = other.cap;
+        first = other.first, last = other.last;
+        other.storage = other.first = other.last = pointer();
+        other.cap = 0;
+    }
+
+    // Makes room for `front` more elements before the first one and `back`
+    // more after the last one.
+    void grow(size_type front, size_type back)
+    {
+        size_type n = size(), need = n + front + back;
+        if (need > max_size()) throw std::length_error("Devector::grow: too many elements");
+        // Moving inside the buffer can not be undone if a move throws.
+        if (need <= cap / 2 && std::is_nothrow_move_constructible<T>::value
+            && std::is_nothrow_move_assignable<T>::value) {
+            recenter(storage + front + (cap - need) / 2);
+        }
+        else {
+            size_type new_cap = std::max(std::max(2 * cap, need), size_type(4));
+            reallocate(new_cap, front + (new_cap - need) / 2);
+        }
+    }
+
+    // Moves the elements to a new buffer of `new_cap` slots, the first one
+    // to slot `offset`.
+    void reallocate(size_type new_cap, size_type offset)
+    {
+        pointer p = AllocTraits::allocate(alloc, new_cap), q = p + offset;
+        try {
+            for (pointer i = first; i != last; ++i, ++q) construct(q, std::move_if_noexcept(*i));
+        }
+        catch (...) {
+            for (pointer i = p + offset; i != q; ++i) AllocTraits::destroy(alloc, std::addressof(*i));
+            AllocTraits::deallocate(alloc, p, new_cap);
+            throw;
+        }
+        destroy(first, last);
+        if (storage) AllocTraits::deallocate(alloc, storage, cap);
+        storage = p, cap = new_cap;
+        first = p + offset, last = q;
+    }
+
+    // Moves the elements inside the buffer so that the first one is at `to`.
+    // Slots that were empty are constructed, the others assigned.
+    void recenter(pointer to) noexcept
+    {
+        size_type n = size();
+        if (to < first) {
+            for (size_type i = 0; i < n; ++i) {
+                if (to + i < first) construct(to + i, std::move(first[i]));
+                else to[i] = std::move(first[i]);
+            }
+            destroy(std::max(to + n, first), last);
+        }
+        else if (to > first) {
+            for (size_type i = n; i > 0; --i) {
+                if (to + i - 1 >= last) construct(to + i - 1, std::move(first[i - 1]));
+                else to[i - 1] = std::move(first[i - 1]);
+            }
+            destroy(first, std::min(to, last));
+        }
+        first = to, last = to + n;
+    }
+
+    template<typename InputIt>
+    void append(InputIt from, InputIt to, std::input_iterator_tag)
+    {
+        for (; from != to; ++from) emplace_back(*from);
+    }
+
+    template<typename ForwardIt>
+    void append(ForwardIt from, ForwardIt to, std::forward_iterator_tag)
+    {
+        size_type count = std::distance(from, to);
+        if (count > back_free_capacity()) grow(0, count);
+        pointer p = last;
+        try {
+            for (; from != to; ++from, ++p) construct(p, *from);
+        }
+        catch (...) {
+            destroy(last, p);
+            throw;
+        }
+        last = p;
+    }
+
+    template<typename InputIt>
+    void prepend(InputIt from, InputIt to, std::input_iterator_tag)
+    {
+        size_type old = size();
+        for (; from != to; ++from) emplace_front(*from);
+        std::reverse(first, first + (size() - old));
+    }
+
+    template<typename ForwardIt>
+    void prepend(ForwardIt from, ForwardIt to, std::forward_iterator_tag)
+    {
+        size_type count = std::distance(from, to);
+        if (count > front_free_capacity()) grow(count, 0);
+        pointer p = first - count, q = p;
+        try {
+            for (; from != to; ++from, ++q) construct(q, *from);
+        }
+        catch (...) {
+            destroy(p, q);
+            throw;
+        }
+        first = p;
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("Devector::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
+};
+
+template<typename T, typename Alloc>
+void swap(Devector<T, Alloc>& lhs, Devector<T, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<typename T, typename Alloc>
+bool operator==(const Devector<T, Alloc>& lhs, const Devector<T, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename T, typename Alloc>
+bool operator!=(const Devector<T, Alloc>& lhs, const Devector<T, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<typename T, typename Alloc>
+bool operator<(const Devector<T, Alloc>& lhs, const Devector<T, Alloc>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::Devector.");
+
+#endif
+
+}
+
+#endif
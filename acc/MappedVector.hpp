@@ -0,0 +1,565 @@
+// A vector whose elements live in a memory-mapped file.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <initializer_list>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Deque.hpp"
+#include "BinaryIO.hpp"
+
+#ifndef _ACC_MAPPED_VECTOR
+#define _ACC_MAPPED_VECTOR
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// Where MappedVectors keep their files. It is the allocator_type of
+// MappedVector, so it reaches both blocks of a Deque through the Deque's
+// allocator constructors.
+//
+// Without a name, every vector gets an unnamed temporary file in `directory`
+// ($TMPDIR or /tmp when empty), deleted when the vector goes away. With a
+// name, the vectors built from this object (and its copies) open
+// "<directory>/<name>.0", "<name>.1", ... in the order they are built, and
+// keep them. A Deque builds its front block first, so
+//
+//     acc::MappedDeque<Order> dq(acc::MappedStorage<Order>("orders", "/var/lib/app"));
+//
+// keeps the front block in orders.0 and the back block in orders.1, and
+// finds its elements there again when it is built the same way after a
+// restart.
+template<typename T>
+class MappedStorage
+{
+
+public:
+
+    typedef T value_type;
+
+    MappedStorage(): opened(std::make_shared<std::size_t>(0)) { }
+    explicit MappedStorage(std::string _name, std::string _directory = std::string())
+        : directory(std::move(_directory)), name(std::move(_name)),
+          opened(std::make_shared<std::size_t>(0)) { }
+    template<typename U>
+    MappedStorage(const MappedStorage<U>& other)
+        : directory(other.directory), name(other.name), opened(other.opened) { }
+
+    std::string directory;
+    std::string name;
+
+    // How many files have been claimed through this object and its copies.
+    std::shared_ptr<std::size_t> opened;
+
+    std::string dir() const
+    {
+        if (!directory.empty()) return directory;
+        const char* tmp = std::getenv("TMPDIR");
+        return tmp != nullptr && *tmp != '\0' ? tmp : "/tmp";
+    }
+
+    // The file of the next vector, empty for a temporary one.
+    std::string claim() const
+    {
+        if (name.empty()) return std::string();
+        return dir() + "/" + name + "." + std::to_string((*opened)++);
+    }
+
+};
+
+template<typename T, typename U>
+bool operator==(const MappedStorage<T>& lhs, const MappedStorage<U>& rhs)
+{
+    return lhs.directory == rhs.directory && lhs.name == rhs.name;
+}
+
+template<typename T, typename U>
+bool operator!=(const MappedStorage<T>& lhs, const MappedStorage<U>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+// A vector of trivially copyable T stored in a file mapped with MAP_SHARED.
+// The kernel writes cold pages back to the file and drops them, so a vector
+// can be much larger than RAM, paid for with page faults when cold elements
+// are touched again.
+//
+// The file is a binary file of acc/BinaryIO.hpp: a header, then the
+// elements. Growing extends the file with ftruncate and maps it again; the
+// elements stay in the page cache, so growth copies nothing. Pointers and
+// iterators are invalidated by growth, as for std::vector.
+//
+// The size in the header is brought up to date by sync() and when the
+// vector is destroyed; after a crash, a named file may hold a stale size.
+//
+// It is meant as the Container of acc::Deque: MappedDeque<T> below.
+template<typename T>
+class MappedVector
+{
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MappedVector stores its elements as bytes in a file.");
+
+private:
+
+    typedef MappedVector<T> Self;
+
+public:
+
+    typedef T                                           value_type;
+    typedef MappedStorage<T>                            allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef pointer                                     iterator;
+    typedef const_pointer                               const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    explicit MappedVector(const allocator_type& storage): directory(storage.dir())
+    {
+        file = storage.claim();
+        if (!file.empty()) open_named();
+    }
+    MappedVector(): MappedVector(allocator_type()) { }
+    MappedVector(size_type count, const value_type& value,
+        const allocator_type& storage = allocator_type()): MappedVector(storage)
+    {
+        assign(count, value);
+    }
+    explicit MappedVector(size_type count,
+        const allocator_type& storage = allocator_type()): MappedVector(storage)
+    {
+        resize(count);
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    MappedVector(InputIt first, InputIt last,
+        const allocator_type& storage = allocator_type()): MappedVector(storage)
+    {
+        insert(end(), first, last);
+    }
+    MappedVector(const Self& other, const allocator_type& storage)
+        : MappedVector(storage)
+    {
+        assign(other.begin(), other.end());
+    }
+    MappedVector(const Self& other): MappedVector(other, other.get_allocator()) { }
+    MappedVector(Self&& other) noexcept
+        : directory(std::move(other.directory)), file(std::move(other.file)), fd(other.fd),
+          map(other.map), map_len(other.map_len), first(other.first),
+          count(other.count), cap(other.cap)
+    {
+        other.fd = -1, other.map = nullptr, other.first = nullptr;
+        other.map_len = other.count = other.cap = 0;
+    }
+    MappedVector(std::initializer_list<value_type> init,
+        const allocator_type& storage = allocator_type())
+        : MappedVector(init.begin(), init.end(), storage) { }
+
+    ~MappedVector()
+    {
+        if (map != nullptr) {
+            header()->size = count;
+            ::munmap(map, map_len);
+        }
+        if (fd >= 0) ::close(fd);
+    }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept
+    {
+        Self tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt from, InputIt to)
+    {
+        clear();
+        insert(end(), from, to);
+    }
+    void assign(size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        clear();
+        resize(n, tmp);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    // The directory only: copies of the vector get temporary files.
+    allocator_type get_allocator() const
+    {
+        return allocator_type(std::string(), directory);
+    }
+
+    // The file of a named vector, empty for a temporary one.
+    const std::string& path() const noexcept { return file; }
+
+    reference operator[](size_type pos) { return first[pos]; }
+    const_reference operator[](size_type pos) const { return first[pos]; }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return first[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return first[pos];
+    }
+
+    reference front() { return *first; }
+    const_reference front() const { return *first; }
+    reference back() { return first[count - 1]; }
+    const_reference back() const { return first[count - 1]; }
+
+    pointer data() noexcept { return first; }
+    const_pointer data() const noexcept { return first; }
+
+    iterator begin() noexcept { return first; }
+    const_iterator begin() const noexcept { return first; }
+    const_iterator cbegin() const noexcept { return first; }
+    iterator end() noexcept { return first + count; }
+    const_iterator end() const noexcept { return first + count; }
+    const_iterator cend() const noexcept { return first + count; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    size_type size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    size_type max_size() const noexcept
+    {
+        return (size_type(-1) / 2 - binary_io::data_offset<T>()) / sizeof(T);
+    }
+    size_type capacity() const noexcept { return cap; }
+
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > cap) remap(new_cap);
+    }
+
+    // Gives the unused tail of the file back to the file system.
+    void shrink_to_fit()
+    {
+        if (count < cap) remap(count);
+    }
+
+    void clear() noexcept { count = 0; }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (count == cap) {
+            // args may refer to an element, which the remap moves.
+            value_type tmp(std::forward<Args>(args)...);
+            remap(grown(count + 1));
+            first[count] = tmp;
+        }
+        else ::new (static_cast<void*>(first + count)) value_type(std::forward<Args>(args)...);
+        return first[count++];
+    }
+
+    void pop_back() { --count; }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type off = pos - cbegin();
+        emplace_back(std::forward<Args>(args)...);
+        rotate_in(off, 1);
+        return first + off;
+    }
+
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        size_type off = pos - cbegin();
+        reserve_grown(count + n);
+        std::fill(first + count, first + count + n, tmp);
+        count += n;
+        rotate_in(off, n);
+        return first + off;
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt from, InputIt to)
+    {
+        size_type off = pos - cbegin(), old = count;
+        append(from, to, typename std::iterator_traits<InputIt>::iterator_category());
+        rotate_in(off, count - old);
+        return first + off;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator from, const_iterator to)
+    {
+        size_type f = from - cbegin(), t = to - cbegin();
+        if (f != t) {
+            std::memmove(static_cast<void*>(first + f), first + t, (count - t) * sizeof(T));
+            count -= t - f;
+        }
+        return first + f;
+    }
+
+    void resize(size_type n) { resize(n, value_type()); }
+    void resize(size_type n, const value_type& value)
+    {
+        if (n > count) {
+            value_type tmp(value);
+            reserve_grown(n);
+            std::fill(first + count, first + n, tmp);
+        }
+        count = n;
+    }
+
+    // Writes the size to the header and waits until the file is on disk.
+    void sync()
+    {
+        if (map == nullptr) return;
+        header()->size = count;
+        if (::msync(map, map_len, MS_SYNC) != 0) binary_io::throw_errno("MappedVector::sync");
+    }
+
+    void swap(Self& other) noexcept
+    {
+        using std::swap;
+        swap(directory, other.directory);
+        swap(file, other.file);
+        swap(fd, other.fd);
+        swap(map, other.map);
+        swap(map_len, other.map_len);
+        swap(first, other.first);
+        swap(count, other.count);
+        swap(cap, other.cap);
+    }
+
+    // acc::Deque's rebuild for MappedVector blocks, with memcpy.
+    friend void relocate_reversed(Self& from, Self& to, size_type n)
+    {
+        to.reserve(n);
+        for (size_type i = 0; i < n; ++i) {
+            std::memcpy(static_cast<void*>(to.first + i), from.first + (n - 1 - i), sizeof(T));
+        }
+        to.count = n;
+        from.erase(from.cbegin(), from.cbegin() + n);
+    }
+
+private:
+
+    std::string directory;
+    std::string file;
+    int fd = -1;
+    void* map = nullptr;
+    size_type map_len = 0;
+    pointer first = nullptr;
+    size_type count = 0;
+    size_type cap = 0;
+
+    BinaryHeader* header() const { return static_cast<BinaryHeader*>(map); }
+
+    static size_type page_size()
+    {
+        static const size_type res = size_type(::sysconf(_SC_PAGESIZE));
+        return res;
+    }
+
+    // Opens the named file, mapping the elements it holds already.
+    void open_named()
+    {
+        const char* who = "MappedVector";
+        fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) binary_io::throw_errno(who);
+        // The constructor has not finished, so the destructor will not
+        // close the file if this throws.
+        try {
+            struct stat st;
+            if (::fstat(fd, &st) != 0) binary_io::throw_errno(who);
+            if (st.st_size == 0) return;
+            BinaryHeader h;
+            binary_io::read_all(fd, &h, sizeof(h), who);
+            binary_io::check_header<T>(h, std::uint64_t(st.st_size), who);
+            map_file(size_type(st.st_size));
+            count = size_type(h.size);
+        }
+        catch (...) {
+            ::close(fd);
+            fd = -1;
+            throw;
+        }
+    }
+
+    // Opens an unnamed temporary file: created and unlinked at once, so it
+    // goes away with the descriptor even if the process is killed.
+    void open_temporary()
+    {
+        std::string tmpl = directory + "/acc_mapped_XXXXXX";
+        fd = ::mkstemp(&tmpl[0]);
+        if (fd < 0) binary_io::throw_errno("MappedVector");
+        ::unlink(tmpl.c_str());
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+    void map_file(size_type len)
+    {
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) binary_io::throw_errno("MappedVector");
+        map = p, map_len = len;
+        first = reinterpret_cast<pointer>(static_cast<char*>(map) + binary_io::data_offset<T>());
+        cap = (len - binary_io::data_offset<T>()) / sizeof(T);
+    }
+
+    size_type grown(size_type need) const
+    {
+        if (need > max_size()) throw std::length_error("MappedVector: too many elements");
+        return std::max(2 * cap, need);
+    }
+
+    void reserve_grown(size_type need)
+    {
+        if (need > cap) remap(grown(need));
+    }
+
+    // Resizes the file to hold `new_cap` elements, rounded up to whole pages,
+    // and maps it again. The elements stay in the file.
+    void remap(size_type new_cap)
+    {
+        if (fd < 0) open_temporary();
+        size_type len = binary_io::data_offset<T>() + new_cap * sizeof(T);
+        len = (len + page_size() - 1) / page_size() * page_size();
+        if (map != nullptr) {
+            header()->size = count;
+            ::munmap(map, map_len);
+            map = nullptr, first = nullptr, cap = 0;
+        }
+        if (::ftruncate(fd, off_t(len)) != 0) {
+            int err = errno;
+            // Map the old length again, so the vector stays usable.
+            if (map_len != 0) map_file(map_len);
+            errno = err;
+            binary_io::throw_errno("MappedVector");
+        }
+        map_file(len);
+        if (header()->version == 0) {
+            *header() = binary_io::make_header<T>(0, count);
+        }
+    }
+
+    // The last `n` elements go to position `off`.
+    void rotate_in(size_type off, size_type n)
+    {
+        size_type tail = count - n - off;
+        if (n == 0 || tail == 0) return;
+        std::rotate(first + off, first + count - n, first + count);
+    }
+
+    template<typename InputIt>
+    void append(InputIt from, InputIt to, std::input_iterator_tag)
+    {
+        for (; from != to; ++from) emplace_back(*from);
+    }
+
+    template<typename ForwardIt>
+    void append(ForwardIt from, ForwardIt to, std::forward_iterator_tag)
+    {
+        reserve_grown(count + std::distance(from, to));
+        count = std::copy(from, to, first + count) - first;
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("MappedVector::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
+};
+
+template<typename T>
+void swap(MappedVector<T>& lhs, MappedVector<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// A Deque whose blocks are MappedVectors.
+template<typename T, typename RebuildPolicy = HalfRebuild>
+using MappedDeque = Deque<T, MappedVector<T>, RebuildPolicy>;
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::MappedVector.");
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,502 @@
+// Parallel algorithms over acc::Deque and acc::Vector.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+// A Deque is two contiguous blocks and a Vector a list of power-of-two
+// blocks. The algorithms here cut those blocks into chunks of about 64 KiB
+// and hand the chunks to a ThreadPool, so every task loops over plain
+// pointers. Chunks never straddle a block, and their boundaries depend only
+// on the layout of the container, not on the number of threads, which makes
+// parallel_reduce deterministic: the partial results of the chunks are
+// combined in order on the calling thread, so `op` needs to be associative
+// but not commutative.
+//
+// Every algorithm takes an optional ThreadPool as its first argument and
+// uses default_thread_pool() without one.
+
+#ifndef _ACC_PARALLEL_ALGORITHM
+#define _ACC_PARALLEL_ALGORITHM
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "Deque.hpp"
+#include "Vector.hpp"
+#include "WorkStealingDeque.hpp"
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// Runs parallel_for(n, f) jobs. The calling thread pushes one item per index
+// onto its WorkStealingDeque and works through them from the bottom while the
+// workers, woken for the job, steal from the top. Jobs from different threads
+// run one after another; a parallel_for called from inside a job runs
+// serially on the calling thread. The first exception thrown by `f` is
+// rethrown once the job is over.
+class ThreadPool
+{
+
+public:
+
+    typedef std::size_t size_type;
+
+    // `threads` counts the calling thread, 0 means one per hardware thread.
+    explicit ThreadPool(size_type threads = 0)
+    {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        for (size_type i = 1; i < threads; ++i) workers.emplace_back([this] { work(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_m);
+            stop = true;
+        }
+        wake_cv.notify_all();
+        for (std::thread& t: workers) t.join();
+    }
+
+    // Threads working on a job, the caller included.
+    size_type concurrency() const noexcept { return workers.size() + 1; }
+
+    // Calls f(i) for every i in [0, n), in any order and on any thread.
+    template<typename Func>
+    void parallel_for(size_type n, Func&& f)
+    {
+        if (n == 0) return;
+        if (workers.empty() || n == 1 || inside()) {
+            for (size_type i = 0; i < n; ++i) f(i);
+            return;
+        }
+        typedef typename std::remove_reference<Func>::type F;
+        std::lock_guard<std::mutex> lock(run_m);
+        Job job;
+        job.call = [](void* ctx, size_type i) { (*static_cast<F*>(ctx))(i); };
+        job.ctx = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+        job.remaining.store(n, std::memory_order_relaxed);
+        std::vector<Item> storage(n);
+        for (size_type i = n; i-- > 0; ) {
+            storage[i].job = &job, storage[i].index = i;
+            items.push(&storage[i]);
+        }
+        {
+            std::lock_guard<std::mutex> wake(wake_m);
+            ++generation;
+        }
+        wake_cv.notify_all();
+
+        inside() = true;
+        Item* it;
+        while (items.pop(it)) execute(it);
+        while (job.remaining.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+        inside() = false;
+        if (job.error) std::rethrow_exception(job.error);
+    }
+
+private:
+
+    struct Job
+    {
+        void (*call)(void*, size_type);
+        void* ctx;
+        std::atomic<size_type> remaining;
+        std::mutex error_m;
+        std::exception_ptr error;
+    };
+
+    struct Item
+    {
+        Job* job;
+        size_type index;
+    };
+
+    WorkStealingDeque<Item*> items;
+    std::vector<std::thread> workers;
+    std::mutex run_m;
+    std::mutex wake_m;
+    std::condition_variable wake_cv;
+    std::uint64_t generation = 0;
+    bool stop = false;
+
+    static bool& inside()
+    {
+        static thread_local bool value = false;
+        return value;
+    }
+
+    // The job outlives its items: its caller waits for `remaining` to drop
+    // to zero, which is the last access here.
+    static void execute(Item* it)
+    {
+        Job* job = it->job;
+        try {
+            job->call(job->ctx, it->index);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(job->error_m);
+            if (!job->error) job->error = std::current_exception();
+        }
+        job->remaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    void work()
+    {
+        inside() = true;
+        std::uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(wake_m);
+                wake_cv.wait(lock, [&] { return stop || generation != seen; });
+                if (stop) return;
+                seen = generation;
+            }
+            Item* it;
+            while (!items.empty()) {
+                if (items.steal(it)) execute(it);
+            }
+        }
+    }
+
+};
+
+inline ThreadPool& default_thread_pool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+namespace par
+{
+
+// Elements [data, data + size) are the positions [pos, pos + size) of the
+// sequence, backwards when `reversed` (the front block of a Deque).
+template<typename P>
+struct Chunk
+{
+    P data;
+    std::size_t size;
+    bool reversed;
+    std::size_t pos;
+};
+
+constexpr std::size_t chunk_bytes = 65536;
+
+template<typename T>
+constexpr std::size_t grain()
+{
+    return sizeof(T) >= chunk_bytes ? 1 : chunk_bytes / sizeof(T);
+}
+
+template<typename P>
+void cut(std::vector<Chunk<P>>& out, P data, std::size_t n, bool reversed, std::size_t pos)
+{
+    const std::size_t g = grain<typename std::iterator_traits<P>::value_type>();
+    for (std::size_t s = 0; s < n; s += g) {
+        std::size_t len = std::min(g, n - s);
+        out.push_back(Chunk<P>{reversed ? data + (n - s - len) : data + s, len, reversed, pos + s});
+    }
+}
+
+template<typename T, typename Container, typename RebuildPolicy>
+std::vector<Chunk<T*>> chunks(Deque<T, Container, RebuildPolicy>& dq)
+{
+    std::vector<Chunk<T*>> res;
+    Span<T> f = dq.reversed_front_span(), b = dq.back_span();
+    cut(res, f.data(), f.size(), true, 0);
+    cut(res, b.data(), b.size(), false, f.size());
+    return res;
+}
+template<typename T, typename Container, typename RebuildPolicy>
+std::vector<Chunk<const T*>> chunks(const Deque<T, Container, RebuildPolicy>& dq)
+{
+    std::vector<Chunk<const T*>> res;
+    Span<const T> f = dq.reversed_front_span(), b = dq.back_span();
+    cut(res, f.data(), f.size(), true, 0);
+    cut(res, b.data(), b.size(), false, f.size());
+    return res;
+}
+
+template<typename T, typename Alloc>
+std::vector<Chunk<T*>> chunks(Vector<T, Alloc>& vec)
+{
+    std::vector<Chunk<T*>> res;
+    std::size_t pos = 0;
+    vec.for_each_segment([&](T* p, std::size_t n) {
+        cut(res, p, n, false, pos);
+        pos += n;
+    });
+    return res;
+}
+template<typename T, typename Alloc>
+std::vector<Chunk<const T*>> chunks(const Vector<T, Alloc>& vec)
+{
+    std::vector<Chunk<const T*>> res;
+    std::size_t pos = 0;
+    vec.for_each_segment([&](const T* p, std::size_t n) {
+        cut(res, p, n, false, pos);
+        pos += n;
+    });
+    return res;
+}
+
+// Calls f(x) on the elements of the chunk in sequence order.
+template<typename P, typename Func>
+void walk(const Chunk<P>& c, Func&& f)
+{
+    if (c.reversed) {
+        for (P p = c.data + c.size; p != c.data; ) f(*--p);
+    }
+    else {
+        for (P p = c.data; p != c.data + c.size; ++p) f(*p);
+    }
+}
+
+// Splits merging sorted [a, a + n) and [b, b + m) at output position d:
+// returns how many of the first d outputs come from a. Ties go to a first,
+// as in std::merge.
+template<typename T, typename Compare>
+std::size_t co_rank(std::size_t d, const T* a, std::size_t n, const T* b, std::size_t m,
+                    Compare& comp)
+{
+    std::size_t lo = d > m ? d - m : 0, hi = std::min(d, n);
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2, j = d - i;
+        if (j > 0 && !comp(b[j - 1], a[i])) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+}
+
+template<typename Seq, typename Func>
+void parallel_for_each(ThreadPool& pool, Seq& seq, Func f)
+{
+    auto cs = par::chunks(seq);
+    pool.parallel_for(cs.size(), [&](std::size_t i) { par::walk(cs[i], f); });
+}
+template<typename Seq, typename Func>
+void parallel_for_each(Seq& seq, Func f)
+{
+    parallel_for_each(default_thread_pool(), seq, std::move(f));
+}
+
+// out[i] = op(seq[i]). `out` is a random access iterator, which may be
+// seq.begin() for an in-place transform.
+template<typename Seq, typename RandomIt, typename UnaryOp>
+RandomIt parallel_transform(ThreadPool& pool, const Seq& seq, RandomIt out, UnaryOp op)
+{
+    auto cs = par::chunks(seq);
+    pool.parallel_for(cs.size(), [&](std::size_t i) {
+        auto& c = cs[i];
+        RandomIt o = out + typename std::iterator_traits<RandomIt>::difference_type(c.pos);
+        typedef std::reverse_iterator<decltype(c.data)> Rev;
+        if (c.reversed) std::transform(Rev(c.data + c.size), Rev(c.data), o, op);
+        else std::transform(c.data, c.data + c.size, o, op);
+    });
+    return out + typename std::iterator_traits<RandomIt>::difference_type(seq.size());
+}
+template<typename Seq, typename RandomIt, typename UnaryOp>
+RandomIt parallel_transform(const Seq& seq, RandomIt out, UnaryOp op)
+{
+    return parallel_transform(default_thread_pool(), seq, out, std::move(op));
+}
+
+template<typename Seq, typename RandomIt>
+RandomIt parallel_copy(ThreadPool& pool, const Seq& seq, RandomIt out)
+{
+    auto cs = par::chunks(seq);
+    pool.parallel_for(cs.size(), [&](std::size_t i) {
+        auto& c = cs[i];
+        RandomIt o = out + typename std::iterator_traits<RandomIt>::difference_type(c.pos);
+        if (c.reversed) std::reverse_copy(c.data, c.data + c.size, o);
+        else std::copy(c.data, c.data + c.size, o);
+    });
+    return out + typename std::iterator_traits<RandomIt>::difference_type(seq.size());
+}
+template<typename Seq, typename RandomIt>
+RandomIt parallel_copy(const Seq& seq, RandomIt out)
+{
+    return parallel_copy(default_thread_pool(), seq, out);
+}
+
+// Folds every chunk in sequence order, starting from its first element, then
+// folds init and the chunk results in order. The result is the same for any
+// number of threads.
+template<typename Seq, typename T, typename BinaryOp = std::plus<T>>
+T parallel_reduce(ThreadPool& pool, const Seq& seq, T init, BinaryOp op = BinaryOp())
+{
+    auto cs = par::chunks(seq);
+    std::vector<T> part(cs.size(), init);
+    pool.parallel_for(cs.size(), [&](std::size_t i) {
+        auto& c = cs[i];
+        if (c.reversed) {
+            auto p = c.data + c.size;
+            T acc(*--p);
+            while (p != c.data) acc = op(std::move(acc), *--p);
+            part[i] = std::move(acc);
+        }
+        else {
+            auto p = c.data;
+            T acc(*p++);
+            for (; p != c.data + c.size; ++p) acc = op(std::move(acc), *p);
+            part[i] = std::move(acc);
+        }
+    });
+    for (T& x: part) init = op(std::move(init), std::move(x));
+    return init;
+}
+template<typename Seq, typename T, typename BinaryOp = std::plus<T>>
+T parallel_reduce(const Seq& seq, T init, BinaryOp op = BinaryOp())
+{
+    return parallel_reduce(default_thread_pool(), seq, std::move(init), std::move(op));
+}
+
+// The first element satisfying `pred`, or end(). Chunks after the best match
+// found so far are skipped.
+template<typename Seq, typename UnaryPred>
+auto parallel_find_if(ThreadPool& pool, Seq& seq, UnaryPred pred) -> decltype(seq.begin())
+{
+    auto cs = par::chunks(seq);
+    std::atomic<std::size_t> best(seq.size());
+    pool.parallel_for(cs.size(), [&](std::size_t i) {
+        auto& c = cs[i];
+        if (c.pos >= best.load(std::memory_order_relaxed)) return;
+        std::size_t found = c.size;
+        if (c.reversed) {
+            for (std::size_t j = c.size; j-- > 0; ) {
+                if (pred(c.data[j])) {
+                    found = c.size - 1 - j;
+                    break;
+                }
+            }
+        }
+        else found = std::size_t(std::find_if(c.data, c.data + c.size, pred) - c.data);
+        if (found == c.size) return;
+        std::size_t pos = c.pos + found, cur = best.load(std::memory_order_relaxed);
+        while (pos < cur && !best.compare_exchange_weak(cur, pos)) { }
+    });
+    return seq.begin() + typename std::iterator_traits<decltype(seq.begin())>::difference_type(
+        best.load());
+}
+template<typename Seq, typename UnaryPred>
+auto parallel_find_if(Seq& seq, UnaryPred pred) -> decltype(seq.begin())
+{
+    return parallel_find_if(default_thread_pool(), seq, std::move(pred));
+}
+
+// Moves the elements into a buffer, sorts a few runs per thread there, merges
+// them pairwise, every merge cut into pieces at co-ranks so all threads take
+// part down to the last one, and moves the result back. T must be default
+// constructible; the sort is not stable.
+template<typename Seq, typename Compare = std::less<typename Seq::value_type>>
+void parallel_sort(ThreadPool& pool, Seq& seq, Compare comp = Compare())
+{
+    typedef typename Seq::value_type T;
+    const std::size_t n = seq.size();
+    if (n < 2) return;
+    auto cs = par::chunks(seq);
+    std::unique_ptr<T[]> a(new T[n]), b(new T[n]);
+
+    pool.parallel_for(cs.size(), [&](std::size_t i) {
+        auto& c = cs[i];
+        if (c.reversed) std::move(std::reverse_iterator<T*>(c.data + c.size),
+                                  std::reverse_iterator<T*>(c.data), a.get() + c.pos);
+        else std::move(c.data, c.data + c.size, a.get() + c.pos);
+    });
+
+    const std::size_t g = par::grain<T>();
+    std::size_t runs = std::max<std::size_t>(1, std::min(4 * pool.concurrency(), n / g));
+    std::vector<std::size_t> bound(runs + 1);
+    for (std::size_t r = 0; r <= runs; ++r) bound[r] = n / runs * r + std::min(r, n % runs);
+    pool.parallel_for(runs, [&](std::size_t r) {
+        std::sort(a.get() + bound[r], a.get() + bound[r + 1], comp);
+    });
+
+    // A piece of output [d0, d1) of merging runs [lo, mid) and [mid, hi).
+    struct Piece { std::size_t lo, mid, hi, d0, d1; };
+    const std::size_t piece = std::max(g, n / (4 * pool.concurrency()));
+    T* from = a.get();
+    T* to = b.get();
+    while (bound.size() > 2) {
+        std::vector<Piece> pieces;
+        std::vector<std::size_t> next;
+        for (std::size_t r = 0; r + 1 < bound.size(); r += 2) {
+            std::size_t lo = bound[r], mid = bound[r + 1];
+            std::size_t hi = r + 2 < bound.size() ? bound[r + 2] : mid;
+            for (std::size_t d = lo; d < hi; d += piece) {
+                pieces.push_back(Piece{lo, mid, hi, d, std::min(d + piece, hi)});
+            }
+            next.push_back(lo);
+        }
+        next.push_back(n);
+        pool.parallel_for(pieces.size(), [&](std::size_t k) {
+            const Piece& p = pieces[k];
+            const T* x = from + p.lo;
+            const T* y = from + p.mid;
+            std::size_t xn = p.mid - p.lo, yn = p.hi - p.mid;
+            std::size_t i0 = par::co_rank(p.d0 - p.lo, x, xn, y, yn, comp);
+            std::size_t i1 = par::co_rank(p.d1 - p.lo, x, xn, y, yn, comp);
+            std::merge(std::make_move_iterator(from + p.lo + i0),
+                       std::make_move_iterator(from + p.lo + i1),
+                       std::make_move_iterator(from + p.mid + (p.d0 - p.lo - i0)),
+                       std::make_move_iterator(from + p.mid + (p.d1 - p.lo - i1)),
+                       to + p.d0, comp);
+        });
+        std::swap(from, to);
+        bound.swap(next);
+    }
+
+    pool.parallel_for(cs.size(), [&](std::size_t i) {
+        auto& c = cs[i];
+        T* src = from + c.pos;
+        if (c.reversed) std::move(src, src + c.size, std::reverse_iterator<T*>(c.data + c.size));
+        else std::move(src, src + c.size, c.data);
+    });
+}
+template<typename Seq, typename Compare = std::less<typename Seq::value_type>>
+void parallel_sort(Seq& seq, Compare comp = Compare())
+{
+    parallel_sort(default_thread_pool(), seq, std::move(comp));
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::ParallelAlgorithm.");
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,288 @@
+// A priority queue on a d-ary heap.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include <vector>
+
+#include "Allocator.hpp"
+
+#ifndef _ACC_PRIORITY_QUEUE
+#define _ACC_PRIORITY_QUEUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// Like std::priority_queue, top() is the greatest element under Compare,
+// but the heap is `Arity`-ary: every node has up to Arity children, so the
+// heap is log(Arity) times shallower than a binary heap. A pop compares all
+// children of a node on each level, which for Arity * sizeof(T) up to a
+// cache line touches one line per level instead of one per two levels.
+//
+// The children of a node are kept in one aligned group: the container
+// starts with Arity - 1 unused slots (for default constructible T), so the
+// children of element i, at indices Arity * i + 1 ..., are in slots
+// Arity * (i + 1) ... Arity * (i + 1) + Arity - 1. The default Container
+// aligns its buffer to a cache line, so for 8-byte elements and Arity 8 the
+// children of every node are exactly one line. Any container with random
+// access, push_back, pop_back and back works, e.g. acc::Vector or acc::Deque,
+// whose blocks keep aligned groups together as well.
+template<typename T, typename Compare = std::less<T>,
+         typename Container = std::vector<T, CacheAlignedAllocator<T>>,
+         std::size_t Arity = 4>
+class PriorityQueue
+{
+
+    static_assert(Arity >= 2, "A heap node has at least two children.");
+
+private:
+
+    typedef PriorityQueue<T, Compare, Container, Arity> Self;
+
+public:
+
+    typedef Container                                   container_type;
+    typedef Compare                                     value_compare;
+    typedef typename Container::value_type              value_type;
+    typedef typename Container::size_type               size_type;
+    typedef typename Container::reference               reference;
+    typedef typename Container::const_reference         const_reference;
+
+    static constexpr size_type arity = Arity;
+
+    PriorityQueue(): PriorityQueue(Compare()) { }
+    explicit PriorityQueue(const Compare& compare, Container cont = Container())
+        : c(std::move(cont)), comp(compare)
+    {
+        heapify_container();
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    PriorityQueue(InputIt first, InputIt last, const Compare& compare = Compare())
+        : PriorityQueue(compare)
+    {
+        push_range(first, last);
+    }
+    PriorityQueue(std::initializer_list<value_type> init, const Compare& compare = Compare())
+        : PriorityQueue(init.begin(), init.end(), compare) { }
+
+    const_reference top() const { return c[pad]; }
+
+    bool empty() const { return size() == 0; }
+    size_type size() const { return c.empty() ? 0 : c.size() - pad; }
+
+    void push(const value_type& value)
+    {
+        fill_pad();
+        c.push_back(value);
+        sift_up(size() - 1);
+    }
+    void push(value_type&& value)
+    {
+        fill_pad();
+        c.push_back(std::move(value));
+        sift_up(size() - 1);
+    }
+
+    template<class... Args>
+    void emplace(Args&&... args)
+    {
+        fill_pad();
+        c.emplace_back(std::forward<Args>(args)...);
+        sift_up(size() - 1);
+    }
+
+    // Appends the elements and restores the heap. Many elements at once are
+    // put in place bottom-up in O(n) for the whole heap; a few are sifted up
+    // one by one in O(log n) each.
+    template<typename InputIt>
+    void push_range(InputIt first, InputIt last)
+    {
+        fill_pad();
+        size_type old = size();
+        for (; first != last; ++first) c.push_back(*first);
+        restore(old);
+    }
+    template<typename Range>
+    void push_range(Range&& rg)
+    {
+        using std::begin;
+        using std::end;
+        push_range(begin(rg), end(rg));
+    }
+
+    void pop()
+    {
+        value_type last = std::move(c.back());
+        c.pop_back();
+        if (!empty()) sift_down_to_leaf(std::move(last));
+    }
+
+    // Replaces the top by `value`: pop() then push() with a single pass down
+    // the heap, e.g. to reschedule the task just taken.
+    void pop_push(const value_type& value)
+    {
+        sift_down(0, value_type(value));
+    }
+    void pop_push(value_type&& value)
+    {
+        sift_down(0, std::move(value));
+    }
+
+    void swap(Self& other) noexcept(noexcept(std::declval<Container&>().swap(
+        std::declval<Container&>())))
+    {
+        using std::swap;
+        swap(c, other.c);
+        swap(comp, other.comp);
+    }
+
+protected:
+
+    Container c;
+    Compare comp;
+
+private:
+
+    // Unused slots before the root. Types without a default constructor
+    // start at slot 0: same heap, without the alignment of the groups.
+    static constexpr size_type pad =
+        std::is_default_constructible<value_type>::value ? Arity - 1 : 0;
+
+    reference at(size_type i) { return c[i + pad]; }
+
+    void fill_pad()
+    {
+        fill_pad(std::integral_constant<bool, pad != 0>());
+    }
+    void fill_pad(std::true_type)
+    {
+        while (c.size() < pad) c.emplace_back();
+    }
+    void fill_pad(std::false_type) { }
+
+    void sift_up(size_type i)
+    {
+        if (i == 0) return;
+        value_type v = std::move(at(i));
+        while (i > 0) {
+            size_type p = (i - 1) / Arity;
+            if (!comp(at(p), v)) break;
+            at(i) = std::move(at(p));
+            i = p;
+        }
+        at(i) = std::move(v);
+    }
+
+    // Puts `v` into the hole at `i`, moving the greatest child up while it
+    // is greater than `v`.
+    void sift_down(size_type i, value_type&& v)
+    {
+        size_type n = size();
+        while (true) {
+            size_type first = i * Arity + 1;
+            if (first >= n) break;
+            size_type best = best_child(first, n);
+            if (!comp(v, at(best))) break;
+            at(i) = std::move(at(best));
+            i = best;
+        }
+        at(i) = std::move(v);
+    }
+
+    // The same for a `v` from the bottom of the heap, which pop() reinserts:
+    // it belongs near the bottom again, so the hole goes down to a leaf
+    // without comparing with `v`, and `v` is sifted up from there (Floyd's
+    // bottom-up method). That saves a comparison per level.
+    void sift_down_to_leaf(value_type&& v)
+    {
+        size_type i = 0, n = size();
+        while (true) {
+            size_type first = i * Arity + 1;
+            if (first >= n) break;
+            size_type best = best_child(first, n);
+            at(i) = std::move(at(best));
+            i = best;
+        }
+        at(i) = std::move(v);
+        sift_up(i);
+    }
+
+    // The greatest of the children from `first` on.
+    size_type best_child(size_type first, size_type n)
+    {
+        size_type last = first + Arity < n ? first + Arity : n, best = first;
+        for (size_type j = first + 1; j < last; ++j) {
+            if (comp(at(best), at(j))) best = j;
+        }
+        return best;
+    }
+
+    // Restores the heap after elements [old, size()) were appended to a heap
+    // of `old` elements.
+    void restore(size_type old)
+    {
+        size_type n = size();
+        if (n - old <= old / 4) {
+            for (size_type i = old; i < n; ++i) sift_up(i);
+            return;
+        }
+        for (size_type i = n > 1 ? (n - 2) / Arity + 1 : 0; i-- > 0; ) {
+            sift_down(i, value_type(std::move(at(i))));
+        }
+    }
+
+    // A container given to the constructor holds elements only: shift them
+    // behind the pad first.
+    void heapify_container()
+    {
+        if (c.empty()) return;
+        size_type n = c.size();
+        grow_pad(std::integral_constant<bool, pad != 0>());
+        for (size_type i = n; i-- > 0 && pad != 0; ) c[i + pad] = std::move(c[i]);
+        restore(0);
+    }
+    void grow_pad(std::true_type)
+    {
+        for (size_type k = 0; k < pad; ++k) c.emplace_back();
+    }
+    void grow_pad(std::false_type) { }
+
+};
+
+template<typename T, typename Compare, typename Container, std::size_t Arity>
+void swap(PriorityQueue<T, Compare, Container, Arity>& lhs,
+          PriorityQueue<T, Compare, Container, Arity>& rhs) noexcept(noexcept(lhs.swap(rhs)))
+{
+    lhs.swap(rhs);
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::PriorityQueue.");
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,418 @@
+// A deque with worst-case constant time push and pop.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <initializer_list>
+
+#include "IndexingIterator.hpp"
+
+#ifndef _ACC_REALTIME_DEQUE
+#define _ACC_REALTIME_DEQUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// Elements live in a power-of-two ring buffer and are addressed by a virtual
+// index, element `v` being stored at slot `v & mask`. When the ring is full,
+// a buffer twice as large is allocated and the old elements are migrated a
+// few per operation, so no push or pop ever does more than constant work.
+// While migrating, the virtual indices in [mlo, mhi) are still in the old
+// buffer. Iterators hold virtual indices and stay valid during migration.
+template<typename T, typename Alloc = std::allocator<T>>
+class RealtimeDeque
+{
+
+private:
+
+    typedef RealtimeDeque<T, Alloc> Self;
+    typedef std::allocator_traits<Alloc> AllocTraits;
+
+public:
+
+    DERIVE_ACC_INDEXING_ITERATOR(_Iterator, at_unsafe)
+
+    typedef T                                           value_type;
+    typedef Alloc                                       allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef typename AllocTraits::pointer               pointer;
+    typedef typename AllocTraits::const_pointer         const_pointer;
+    typedef _Iterator<T&, pointer>                      iterator;
+    typedef _Iterator<const T&, const_pointer>          const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    explicit RealtimeDeque(const allocator_type& alloc): alloc(alloc) { }
+    RealtimeDeque(): RealtimeDeque(allocator_type()) { }
+    RealtimeDeque(size_type count, const value_type& value,
+        const allocator_type& alloc = allocator_type()): RealtimeDeque(alloc)
+    {
+        reserve(count);
+        while (count--) push_back(value);
+    }
+    explicit RealtimeDeque(size_type count,
+        const allocator_type& alloc = allocator_type()): RealtimeDeque(alloc)
+    {
+        reserve(count);
+        while (count--) emplace_back();
+    }
+    template<typename InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    RealtimeDeque(InputIt first, InputIt last,
+        const allocator_type& alloc = allocator_type()): RealtimeDeque(alloc)
+    {
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    RealtimeDeque(const Self& other): RealtimeDeque(other.begin(), other.end(),
+        AllocTraits::select_on_container_copy_construction(other.alloc)) { }
+    RealtimeDeque(Self&& other) noexcept: alloc(std::move(other.alloc))
+    {
+        steal(other);
+    }
+    RealtimeDeque(std::initializer_list<value_type> init,
+        const allocator_type& alloc = allocator_type())
+        : RealtimeDeque(init.begin(), init.end(), alloc) { }
+
+    ~RealtimeDeque()
+    {
+        clear();
+        deallocate(cur_data, cur_mask);
+    }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            deallocate(cur_data, cur_mask);
+            alloc = std::move(other.alloc);
+            steal(other);
+        }
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<class InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    void assign(size_type count, const value_type& value)
+    {
+        clear();
+        while (count--) push_back(value);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc; }
+
+    reference operator[](size_type pos) { return *at_unsafe(head + pos); }
+    const_reference operator[](size_type pos) const
+    {
+        return *const_cast<Self*>(this)->at_unsafe(head + pos);
+    }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[length - 1]; }
+    const_reference back() const { return (*this)[length - 1]; }
+
+    iterator begin() { return iterator(head, this); }
+    const_iterator begin() const { return const_iterator(head, this); }
+    const_iterator cbegin() const { return const_iterator(head, this); }
+    iterator end() { return iterator(head + length, this); }
+    const_iterator end() const { return const_iterator(head + length, this); }
+    const_iterator cend() const { return const_iterator(head + length, this); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+
+    size_type size() const { return length; }
+    bool empty() const { return length == 0; }
+    size_type max_size() const { return AllocTraits::max_size(alloc) / 2; }
+    size_type capacity() const { return cur_data ? cur_mask + 1 : 0; }
+
+    void clear()
+    {
+        while (length) pop_back();
+        finish_migration();
+        head = 0;
+    }
+
+    // Not constant time: finishes the migration and moves every element to
+    // a buffer of at least `new_cap` slots.
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > capacity()) reallocate(new_cap);
+    }
+    void shrink_to_fit()
+    {
+        if (length == 0) {
+            finish_migration();
+            deallocate(cur_data, cur_mask);
+            cur_data = pointer(), cur_mask = 0;
+        }
+        else if (ceil2(length) < capacity()) reallocate(length);
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+    void push_front(const value_type& val) { emplace_front(val); }
+    void push_front(value_type&& val) { emplace_front(std::move(val)); }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        make_room();
+        pointer p = cur_data + ((head + length) & cur_mask);
+        AllocTraits::construct(alloc, std::addressof(*p), std::forward<Args>(args)...);
+        ++length;
+        migrate_step();
+        return *p;
+    }
+
+    template<class... Args>
+    reference emplace_front(Args&&... args)
+    {
+        make_room();
+        pointer p = cur_data + ((head - 1) & cur_mask);
+        AllocTraits::construct(alloc, std::addressof(*p), std::forward<Args>(args)...);
+        --head, ++length;
+        migrate_step();
+        return *p;
+    }
+
+    void pop_back()
+    {
+        size_type v = head + length - 1;
+        AllocTraits::destroy(alloc, std::addressof(*at_unsafe(v)));
+        if (in_old(v)) --mhi;
+        --length;
+        migrate_step();
+    }
+
+    void pop_front()
+    {
+        AllocTraits::destroy(alloc, std::addressof(*at_unsafe(head)));
+        if (in_old(head)) ++mlo;
+        ++head, --length;
+        migrate_step();
+    }
+
+    void swap(Self& other) noexcept
+    {
+        using std::swap;
+        swap(alloc, other.alloc);
+        swap(cur_data, other.cur_data);
+        swap(cur_mask, other.cur_mask);
+        swap(old_data, other.old_data);
+        swap(old_mask, other.old_mask);
+        swap(head, other.head);
+        swap(length, other.length);
+        swap(mlo, other.mlo);
+        swap(mhi, other.mhi);
+    }
+
+private:
+
+    // Elements migrated per operation. Migration starts with the ring full,
+    // so it completes long before the new ring can fill up.
+    static constexpr size_type migrate_per_op = 2;
+
+    allocator_type alloc;
+    pointer cur_data = pointer();
+    size_type cur_mask = 0;
+    pointer old_data = pointer();
+    size_type old_mask = 0;
+    size_type head = 0;
+    size_type length = 0;
+    size_type mlo = 0;
+    size_type mhi = 0;
+
+    bool in_old(size_type v) const { return v - mlo < mhi - mlo; }
+
+    pointer at_unsafe(size_type v)
+    {
+        if (in_old(v)) return old_data + (v & old_mask);
+        return cur_data + (v & cur_mask);
+    }
+
+    static size_type ceil2(size_type n)
+    {
+        size_type c = 1;
+        while (c < n) c <<= 1;
+        return c;
+    }
+
+    void deallocate(pointer p, size_type mask)
+    {
+        if (p) AllocTraits::deallocate(alloc, p, mask + 1);
+    }
+
+    void steal(Self& other) noexcept
+    {
+        cur_data = other.cur_data, cur_mask = other.cur_mask;
+        old_data = other.old_data, old_mask = other.old_mask;
+        head = other.head, length = other.length;
+        mlo = other.mlo, mhi = other.mhi;
+        other.cur_data = other.old_data = pointer();
+        other.cur_mask = other.old_mask = 0;
+        other.head = other.length = other.mlo = other.mhi = 0;
+    }
+
+    void make_room()
+    {
+        if (cur_data == pointer()) {
+            cur_data = AllocTraits::allocate(alloc, 1);
+            cur_mask = 0;
+        }
+        else if (length == cur_mask + 1) {
+            pointer p = AllocTraits::allocate(alloc, 2 * (cur_mask + 1));
+            old_data = cur_data, old_mask = cur_mask;
+            cur_data = p, cur_mask = 2 * cur_mask + 1;
+            mlo = head, mhi = head + length;
+        }
+    }
+
+    void migrate_one()
+    {
+        size_type v = mhi - 1;
+        pointer from = old_data + (v & old_mask);
+        AllocTraits::construct(alloc, std::addressof(*(cur_data + (v & cur_mask))),
+                               std::move_if_noexcept(*from));
+        AllocTraits::destroy(alloc, std::addressof(*from));
+        mhi = v;
+    }
+
+    void migrate_step()
+    {
+        if (old_data == pointer()) return;
+        for (size_type i = 0; i < migrate_per_op && mlo != mhi; ++i) migrate_one();
+        if (mlo == mhi) {
+            deallocate(old_data, old_mask);
+            old_data = pointer(), old_mask = 0;
+        }
+    }
+
+    void finish_migration()
+    {
+        if (old_data == pointer()) return;
+        while (mlo != mhi) migrate_one();
+        deallocate(old_data, old_mask);
+        old_data = pointer(), old_mask = 0;
+        mlo = mhi = 0;
+    }
+
+    void reallocate(size_type new_cap)
+    {
+        finish_migration();
+        size_type cap = ceil2(new_cap);
+        pointer p = AllocTraits::allocate(alloc, cap);
+        for (size_type i = 0; i < length; ++i) {
+            pointer from = cur_data + ((head + i) & cur_mask);
+            AllocTraits::construct(alloc, std::addressof(*(p + i)),
+                                   std::move_if_noexcept(*from));
+            AllocTraits::destroy(alloc, std::addressof(*from));
+        }
+        deallocate(cur_data, cur_mask);
+        cur_data = p, cur_mask = cap - 1, head = 0;
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("RealtimeDeque::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
+};
+
+template<typename T, typename Alloc>
+void swap(RealtimeDeque<T, Alloc>& lhs, RealtimeDeque<T, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<typename T, typename Alloc>
+bool operator==(const RealtimeDeque<T, Alloc>& lhs, const RealtimeDeque<T, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename T, typename Alloc>
+bool operator!=(const RealtimeDeque<T, Alloc>& lhs, const RealtimeDeque<T, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<typename T, typename Alloc>
+bool operator<(const RealtimeDeque<T, Alloc>& lhs, const RealtimeDeque<T, Alloc>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::RealtimeDeque.");
+
+#endif
+
+}
+
+#endif
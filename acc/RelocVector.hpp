@@ -0,0 +1,502 @@
+// A vector that grows with realloc when its elements can be moved as bytes.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <initializer_list>
+
+#include "Deque.hpp"
+
+#ifndef _ACC_RELOC_VECTOR
+#define _ACC_RELOC_VECTOR
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// Whether an object of type T may be moved to another address by copying its
+// bytes and forgetting the original, without running its move constructor or
+// destructor. True for trivially copyable types. Most other types are
+// relocatable too, as long as they hold no pointer into themselves; opt them
+// in by specializing, e.g.
+//
+//     struct Task { std::unique_ptr<Job> job; int priority; };
+//     template<> struct acc::is_trivially_relocatable<Task>: std::true_type { };
+template<typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+// A vector on malloc'ed memory. For trivially relocatable T it grows with
+// std::realloc, which can often extend the block in place and, for large
+// blocks, lets glibc move the pages with mremap instead of copying them, and
+// it shifts elements on insert, erase and Deque rebuilds with memcpy and
+// memmove. Other element types take the same paths as std::vector.
+//
+// It is meant as the Container of acc::Deque: RelocDeque<T> below.
+template<typename T>
+class RelocVector
+{
+
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "RelocVector stores its elements in malloc'ed memory.");
+
+private:
+
+    typedef RelocVector<T> Self;
+    typedef std::integral_constant<bool, is_trivially_relocatable<T>::value> Bytewise;
+
+public:
+
+    typedef T                                           value_type;
+    typedef std::allocator<T>                           allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef pointer                                     iterator;
+    typedef const_pointer                               const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    explicit RelocVector(const allocator_type&) noexcept { }
+    RelocVector() noexcept { }
+    RelocVector(size_type count, const value_type& value,
+        const allocator_type& alloc = allocator_type()): RelocVector(alloc)
+    {
+        assign(count, value);
+    }
+    explicit RelocVector(size_type count,
+        const allocator_type& alloc = allocator_type()): RelocVector(alloc)
+    {
+        resize(count);
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    RelocVector(InputIt first, InputIt last,
+        const allocator_type& alloc = allocator_type()): RelocVector(alloc)
+    {
+        insert(end(), first, last);
+    }
+    RelocVector(const Self& other)
+    {
+        insert(end(), other.begin(), other.end());
+    }
+    RelocVector(const Self& other, const allocator_type&): RelocVector(other) { }
+    RelocVector(Self&& other) noexcept
+        : first(other.first), count(other.count), cap(other.cap)
+    {
+        other.first = nullptr, other.count = other.cap = 0;
+    }
+    RelocVector(std::initializer_list<value_type> init,
+        const allocator_type& alloc = allocator_type())
+        : RelocVector(init.begin(), init.end(), alloc) { }
+
+    ~RelocVector()
+    {
+        destroy(first, first + count);
+        std::free(first);
+    }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept
+    {
+        Self tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt from, InputIt to)
+    {
+        clear();
+        insert(end(), from, to);
+    }
+    void assign(size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        clear();
+        resize(n, tmp);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept { return allocator_type(); }
+
+    reference operator[](size_type pos) { return first[pos]; }
+    const_reference operator[](size_type pos) const { return first[pos]; }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return first[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return first[pos];
+    }
+
+    reference front() { return *first; }
+    const_reference front() const { return *first; }
+    reference back() { return first[count - 1]; }
+    const_reference back() const { return first[count - 1]; }
+
+    pointer data() noexcept { return first; }
+    const_pointer data() const noexcept { return first; }
+
+    iterator begin() noexcept { return first; }
+    const_iterator begin() const noexcept { return first; }
+    const_iterator cbegin() const noexcept { return first; }
+    iterator end() noexcept { return first + count; }
+    const_iterator end() const noexcept { return first + count; }
+    const_iterator cend() const noexcept { return first + count; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    size_type size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    size_type max_size() const noexcept { return size_type(-1) / 2 / sizeof(T); }
+    size_type capacity() const noexcept { return cap; }
+
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > cap) reallocate(new_cap);
+    }
+
+    void shrink_to_fit()
+    {
+        if (count == cap) return;
+        if (count == 0) {
+            std::free(first);
+            first = nullptr, cap = 0;
+        }
+        else reallocate(count);
+    }
+
+    void clear() noexcept
+    {
+        destroy(first, first + count);
+        count = 0;
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (count == cap) {
+            // args may refer to an element, which the growth moves.
+            value_type tmp(std::forward<Args>(args)...);
+            reallocate(grown(count + 1));
+            ::new (static_cast<void*>(first + count)) value_type(std::move(tmp));
+        }
+        else ::new (static_cast<void*>(first + count)) value_type(std::forward<Args>(args)...);
+        return first[count++];
+    }
+
+    void pop_back()
+    {
+        first[--count].~value_type();
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type off = pos - cbegin();
+        emplace_back(std::forward<Args>(args)...);
+        rotate_in(off, 1, Bytewise());
+        return first + off;
+    }
+
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        size_type off = pos - cbegin();
+        reserve_grown(count + n);
+        for (size_type i = 0; i < n; ++i) emplace_back(tmp);
+        rotate_in(off, n, Bytewise());
+        return first + off;
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt from, InputIt to)
+    {
+        size_type off = pos - cbegin(), old = count;
+        append(from, to, typename std::iterator_traits<InputIt>::iterator_category());
+        rotate_in(off, count - old, Bytewise());
+        return first + off;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator from, const_iterator to)
+    {
+        size_type f = from - cbegin(), t = to - cbegin();
+        if (f != t) close_gap(f, t, Bytewise());
+        return first + f;
+    }
+
+    void resize(size_type n)
+    {
+        if (n <= count) destroy_back(n);
+        else {
+            reserve_grown(n);
+            while (count < n) emplace_back();
+        }
+    }
+    void resize(size_type n, const value_type& value)
+    {
+        if (n <= count) destroy_back(n);
+        else {
+            value_type tmp(value);
+            reserve_grown(n);
+            while (count < n) emplace_back(tmp);
+        }
+    }
+
+    void swap(Self& other) noexcept
+    {
+        using std::swap;
+        swap(first, other.first);
+        swap(count, other.count);
+        swap(cap, other.cap);
+    }
+
+    // acc::Deque's rebuild for RelocVector blocks: moves the first `n`
+    // elements of `from` into the empty `to` in reverse order and closes the
+    // gap in `from`. Relocatable elements are copied as bytes.
+    friend void relocate_reversed(Self& from, Self& to, size_type n)
+    {
+        to.reserve(n);
+        from.relocate_prefix(to, n, Bytewise());
+    }
+
+private:
+
+    pointer first = nullptr;
+    size_type count = 0;
+    size_type cap = 0;
+
+    static void destroy(pointer from, pointer to) noexcept
+    {
+        for (; from != to; ++from) from->~value_type();
+    }
+
+    void destroy_back(size_type n) noexcept
+    {
+        destroy(first + n, first + count);
+        count = n;
+    }
+
+    size_type grown(size_type need) const
+    {
+        if (need > max_size()) throw std::length_error("RelocVector: too many elements");
+        return std::max(2 * cap, need);
+    }
+
+    void reserve_grown(size_type need)
+    {
+        if (need > cap) reallocate(grown(need));
+    }
+
+    void reallocate(size_type new_cap)
+    {
+        reallocate(new_cap, Bytewise());
+    }
+
+    void reallocate(size_type new_cap, std::true_type)
+    {
+        void* p = std::realloc(static_cast<void*>(first), new_cap * sizeof(T));
+        if (p == nullptr) throw std::bad_alloc();
+        first = static_cast<pointer>(p), cap = new_cap;
+    }
+
+    void reallocate(size_type new_cap, std::false_type)
+    {
+        pointer p = static_cast<pointer>(std::malloc(new_cap * sizeof(T))), q = p;
+        if (p == nullptr) throw std::bad_alloc();
+        try {
+            for (pointer i = first; i != first + count; ++i, ++q) {
+                ::new (static_cast<void*>(q)) value_type(std::move_if_noexcept(*i));
+            }
+        }
+        catch (...) {
+            destroy(p, q);
+            std::free(p);
+            throw;
+        }
+        destroy(first, first + count);
+        std::free(first);
+        first = p, cap = new_cap;
+    }
+
+    // The last `n` elements go to position `off`.
+    void rotate_in(size_type off, size_type n, std::true_type)
+    {
+        size_type tail = count - n - off;
+        if (n == 0 || tail == 0) return;
+        if (n > 16) {
+            std::rotate(first + off, first + count - n, first + count);
+            return;
+        }
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[16];
+        std::memcpy(static_cast<void*>(buf), first + off + tail, n * sizeof(T));
+        std::memmove(static_cast<void*>(first + off + n), first + off, tail * sizeof(T));
+        std::memcpy(static_cast<void*>(first + off), buf, n * sizeof(T));
+    }
+
+    void rotate_in(size_type off, size_type n, std::false_type)
+    {
+        std::rotate(first + off, first + count - n, first + count);
+    }
+
+    // Removes [f, t).
+    void close_gap(size_type f, size_type t, std::true_type)
+    {
+        destroy(first + f, first + t);
+        std::memmove(static_cast<void*>(first + f), first + t, (count - t) * sizeof(T));
+        count -= t - f;
+    }
+
+    void close_gap(size_type f, size_type t, std::false_type)
+    {
+        pointer nl = std::move(first + t, first + count, first + f);
+        destroy(nl, first + count);
+        count = nl - first;
+    }
+
+    void relocate_prefix(Self& to, size_type n, std::true_type)
+    {
+        for (size_type i = 0; i < n; ++i) {
+            std::memcpy(static_cast<void*>(to.first + i), first + (n - 1 - i), sizeof(T));
+        }
+        to.count = n;
+        if (n < count) {
+            std::memmove(static_cast<void*>(first), first + n, (count - n) * sizeof(T));
+        }
+        count -= n;
+    }
+
+    void relocate_prefix(Self& to, size_type n, std::false_type)
+    {
+        try {
+            for (size_type i = n; i > 0; --i) {
+                to.push_back(std::move_if_noexcept(first[i - 1]));
+            }
+        }
+        catch (...) {
+            to.clear();
+            throw;
+        }
+        close_gap(0, n, std::false_type());
+    }
+
+    template<typename InputIt>
+    void append(InputIt from, InputIt to, std::input_iterator_tag)
+    {
+        for (; from != to; ++from) emplace_back(*from);
+    }
+
+    template<typename ForwardIt>
+    void append(ForwardIt from, ForwardIt to, std::forward_iterator_tag)
+    {
+        reserve_grown(count + std::distance(from, to));
+        pointer p = first + count;
+        try {
+            for (; from != to; ++from, ++p) ::new (static_cast<void*>(p)) value_type(*from);
+        }
+        catch (...) {
+            destroy(first + count, p);
+            throw;
+        }
+        count = p - first;
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("RelocVector::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
+};
+
+template<typename T>
+void swap(RelocVector<T>& lhs, RelocVector<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// A Deque whose blocks are RelocVectors.
+template<typename T, typename RebuildPolicy = HalfRebuild>
+using RelocDeque = Deque<T, RelocVector<T>, RebuildPolicy>;
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::RelocVector.");
+
+#endif
+
+}
+
+#endif
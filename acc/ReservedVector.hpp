@@ -0,0 +1,420 @@
+// A vector in reserved address space, which grows without moving.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <new>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <initializer_list>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "Deque.hpp"
+
+#ifndef _ACC_RESERVED_VECTOR
+#define _ACC_RESERVED_VECTOR
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// A vector that reserves `Reserve` bytes of address space (64 GiB by
+// default) with an inaccessible mmap at its first growth, and makes pages
+// readable and writable with mprotect as it grows. Growth never moves the
+// elements: it costs one mprotect over the new pages, which the kernel backs
+// with memory when they are first written, and pointers, references and
+// iterators to elements stay valid until the element is erased. So growing
+// a huge block needs no second buffer and copies nothing.
+//
+// The reservation holds address space only, not memory: 64 GiB blocks allow
+// about a thousand live ReservedVectors on a 47-bit address space. A vector
+// that never held an element reserves nothing. shrink_to_fit returns the
+// pages past the last element to the system with MADV_DONTNEED.
+//
+// Growing beyond `Reserve` throws std::length_error. It is meant as the
+// Container of acc::Deque: ReservedDeque<T> below.
+template<typename T, std::size_t Reserve = (std::size_t(1) << 36)>
+class ReservedVector
+{
+
+    static_assert(Reserve >= sizeof(T), "ReservedVector must hold one element.");
+
+private:
+
+    typedef ReservedVector<T, Reserve> Self;
+
+public:
+
+    typedef T                                           value_type;
+    typedef std::allocator<T>                           allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef pointer                                     iterator;
+    typedef const_pointer                               const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    explicit ReservedVector(const allocator_type&) noexcept { }
+    ReservedVector() noexcept { }
+    ReservedVector(size_type count, const value_type& value,
+        const allocator_type& alloc = allocator_type()): ReservedVector(alloc)
+    {
+        assign(count, value);
+    }
+    explicit ReservedVector(size_type count,
+        const allocator_type& alloc = allocator_type()): ReservedVector(alloc)
+    {
+        resize(count);
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    ReservedVector(InputIt first, InputIt last,
+        const allocator_type& alloc = allocator_type()): ReservedVector(alloc)
+    {
+        insert(end(), first, last);
+    }
+    ReservedVector(const Self& other)
+    {
+        insert(end(), other.begin(), other.end());
+    }
+    ReservedVector(const Self& other, const allocator_type&): ReservedVector(other) { }
+    ReservedVector(Self&& other) noexcept
+        : first(other.first), count(other.count), cap(other.cap)
+    {
+        other.first = nullptr, other.count = other.cap = 0;
+    }
+    ReservedVector(std::initializer_list<value_type> init,
+        const allocator_type& alloc = allocator_type())
+        : ReservedVector(init.begin(), init.end(), alloc) { }
+
+    ~ReservedVector()
+    {
+        destroy(first, first + count);
+        if (first != nullptr) ::munmap(static_cast<void*>(first), reserved_bytes());
+    }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept
+    {
+        Self tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt from, InputIt to)
+    {
+        clear();
+        insert(end(), from, to);
+    }
+    void assign(size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        clear();
+        resize(n, tmp);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept { return allocator_type(); }
+
+    reference operator[](size_type pos) { return first[pos]; }
+    const_reference operator[](size_type pos) const { return first[pos]; }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return first[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return first[pos];
+    }
+
+    reference front() { return *first; }
+    const_reference front() const { return *first; }
+    reference back() { return first[count - 1]; }
+    const_reference back() const { return first[count - 1]; }
+
+    pointer data() noexcept { return first; }
+    const_pointer data() const noexcept { return first; }
+
+    iterator begin() noexcept { return first; }
+    const_iterator begin() const noexcept { return first; }
+    const_iterator cbegin() const noexcept { return first; }
+    iterator end() noexcept { return first + count; }
+    const_iterator end() const noexcept { return first + count; }
+    const_iterator cend() const noexcept { return first + count; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    size_type size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    static constexpr size_type max_size() noexcept { return Reserve / sizeof(T); }
+
+    // The elements that fit in the accessible pages.
+    size_type capacity() const noexcept { return cap; }
+
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > cap) commit(new_cap);
+    }
+
+    // Gives the pages past the last element back to the system. The address
+    // space stays reserved.
+    void shrink_to_fit()
+    {
+        if (first == nullptr) return;
+        char* base = reinterpret_cast<char*>(first);
+        size_type keep = round_up(count * sizeof(T)), had = round_up(cap * sizeof(T));
+        if (keep < had) {
+            ::madvise(base + keep, had - keep, MADV_DONTNEED);
+            ::mprotect(base + keep, had - keep, PROT_NONE);
+            cap = keep / sizeof(T);
+        }
+    }
+
+    void clear() noexcept
+    {
+        destroy(first, first + count);
+        count = 0;
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+    // Growth does not move the elements, so `args` may refer to one.
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (count == cap) commit(count + 1);
+        ::new (static_cast<void*>(first + count)) value_type(std::forward<Args>(args)...);
+        return first[count++];
+    }
+
+    void pop_back()
+    {
+        first[--count].~value_type();
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type off = pos - cbegin();
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(first + off, first + count - 1, first + count);
+        return first + off;
+    }
+
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        size_type off = pos - cbegin();
+        reserve(count + n);
+        for (size_type i = 0; i < n; ++i) emplace_back(tmp);
+        std::rotate(first + off, first + count - n, first + count);
+        return first + off;
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt from, InputIt to)
+    {
+        size_type off = pos - cbegin(), old = count;
+        append(from, to, typename std::iterator_traits<InputIt>::iterator_category());
+        std::rotate(first + off, first + old, first + count);
+        return first + off;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator from, const_iterator to)
+    {
+        size_type f = from - cbegin(), t = to - cbegin();
+        if (f != t) {
+            pointer nl = std::move(first + t, first + count, first + f);
+            destroy(nl, first + count);
+            count = nl - first;
+        }
+        return first + f;
+    }
+
+    void resize(size_type n)
+    {
+        if (n <= count) destroy_back(n);
+        else {
+            reserve(n);
+            while (count < n) emplace_back();
+        }
+    }
+    void resize(size_type n, const value_type& value)
+    {
+        if (n <= count) destroy_back(n);
+        else {
+            reserve(n);
+            while (count < n) emplace_back(value);
+        }
+    }
+
+    void swap(Self& other) noexcept
+    {
+        using std::swap;
+        swap(first, other.first);
+        swap(count, other.count);
+        swap(cap, other.cap);
+    }
+
+private:
+
+    pointer first = nullptr;
+    size_type count = 0;
+    size_type cap = 0;
+
+    static size_type page_size()
+    {
+        static const size_type res = size_type(::sysconf(_SC_PAGESIZE));
+        return res;
+    }
+
+    static size_type round_up(size_type bytes)
+    {
+        return (bytes + page_size() - 1) / page_size() * page_size();
+    }
+
+    static constexpr size_type reserved_bytes() noexcept
+    {
+        return max_size() * sizeof(T);
+    }
+
+    static void destroy(pointer from, pointer to) noexcept
+    {
+        for (; from != to; ++from) from->~value_type();
+    }
+
+    void destroy_back(size_type n) noexcept
+    {
+        destroy(first + n, first + count);
+        count = n;
+    }
+
+    // Makes room for at least `need` elements, at least doubling the
+    // accessible pages so that a run of pushes makes few system calls.
+    void commit(size_type need)
+    {
+        if (need > max_size()) throw std::length_error("ReservedVector: too many elements");
+        if (first == nullptr) {
+            void* p = ::mmap(nullptr, reserved_bytes(), PROT_NONE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            first = static_cast<pointer>(p);
+        }
+        size_type had = round_up(cap * sizeof(T));
+        size_type want = std::max(round_up(need * sizeof(T)), std::min(2 * had, reserved_bytes()));
+        want = std::min(round_up(want), reserved_bytes());
+        char* base = reinterpret_cast<char*>(first);
+        if (::mprotect(base + had, want - had, PROT_READ | PROT_WRITE) != 0) {
+            throw std::bad_alloc();
+        }
+        cap = want / sizeof(T);
+    }
+
+    template<typename InputIt>
+    void append(InputIt from, InputIt to, std::input_iterator_tag)
+    {
+        for (; from != to; ++from) emplace_back(*from);
+    }
+
+    template<typename ForwardIt>
+    void append(ForwardIt from, ForwardIt to, std::forward_iterator_tag)
+    {
+        reserve(count + std::distance(from, to));
+        for (; from != to; ++from) emplace_back(*from);
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("ReservedVector::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
+};
+
+template<typename T, std::size_t Reserve>
+void swap(ReservedVector<T, Reserve>& lhs, ReservedVector<T, Reserve>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// A Deque whose blocks are ReservedVectors.
+template<typename T, typename RebuildPolicy = HalfRebuild>
+using ReservedDeque = Deque<T, ReservedVector<T>, RebuildPolicy>;
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::ReservedVector.");
+
+#endif
+
+}
+
+#endif
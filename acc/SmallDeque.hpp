@@ -0,0 +1,490 @@
+// A deque that keeps a few elements inside the object.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <string>
+#include <initializer_list>
+
+#include "Deque.hpp"
+
+#ifndef _ACC_SMALL_DEQUE
+#define _ACC_SMALL_DEQUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+// A vector whose first N elements are stored inside the object. Only when it
+// grows beyond N does it allocate, and from then on it behaves like
+// std::vector. The allocator must use plain pointers; it is an empty base
+// where possible.
+template<typename T, std::size_t N, typename Alloc = std::allocator<T>>
+class SmallVector : private Alloc
+{
+
+    static_assert(N > 0, "SmallVector needs at least one inline element.");
+
+private:
+
+    typedef SmallVector<T, N, Alloc> Self;
+    typedef std::allocator_traits<Alloc> AllocTraits;
+
+public:
+
+    typedef T                                           value_type;
+    typedef Alloc                                       allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef pointer                                     iterator;
+    typedef const_pointer                               const_iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+
+    explicit SmallVector(const allocator_type& alloc) noexcept
+        : Alloc(alloc), first(inline_data()), count(0), cap(N) { }
+    SmallVector(): SmallVector(allocator_type()) { }
+    SmallVector(size_type count, const value_type& value,
+        const allocator_type& alloc = allocator_type()): SmallVector(alloc)
+    {
+        assign(count, value);
+    }
+    explicit SmallVector(size_type count,
+        const allocator_type& alloc = allocator_type()): SmallVector(alloc)
+    {
+        resize(count);
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    SmallVector(InputIt first, InputIt last,
+        const allocator_type& alloc = allocator_type()): SmallVector(alloc)
+    {
+        insert(end(), first, last);
+    }
+    SmallVector(const Self& other): SmallVector(other,
+        AllocTraits::select_on_container_copy_construction(other.get_allocator())) { }
+    SmallVector(const Self& other, const allocator_type& alloc): SmallVector(alloc)
+    {
+        insert(end(), other.begin(), other.end());
+    }
+    SmallVector(Self&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : SmallVector(other.get_allocator())
+    {
+        steal(other);
+    }
+    SmallVector(std::initializer_list<value_type> init,
+        const allocator_type& alloc = allocator_type())
+        : SmallVector(init.begin(), init.end(), alloc) { }
+
+    ~SmallVector()
+    {
+        destroy(first, first + count);
+        deallocate();
+    }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other) {
+            clear();
+            deallocate();
+            alloc() = std::move(other.alloc());
+            steal(other);
+        }
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt from, InputIt to)
+    {
+        clear();
+        insert(end(), from, to);
+    }
+    void assign(size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        clear();
+        reserve(n);
+        while (n--) emplace_back(tmp);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc(); }
+
+    reference operator[](size_type pos) { return first[pos]; }
+    const_reference operator[](size_type pos) const { return first[pos]; }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return first[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return first[pos];
+    }
+
+    reference front() { return *first; }
+    const_reference front() const { return *first; }
+    reference back() { return first[count - 1]; }
+    const_reference back() const { return first[count - 1]; }
+
+    pointer data() noexcept { return first; }
+    const_pointer data() const noexcept { return first; }
+
+    iterator begin() noexcept { return first; }
+    const_iterator begin() const noexcept { return first; }
+    const_iterator cbegin() const noexcept { return first; }
+    iterator end() noexcept { return first + count; }
+    const_iterator end() const noexcept { return first + count; }
+    const_iterator cend() const noexcept { return first + count; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    size_type size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    size_type max_size() const noexcept { return AllocTraits::max_size(alloc()); }
+    size_type capacity() const noexcept { return cap; }
+
+    // Whether the elements are stored inside the object.
+    bool is_inline() const noexcept { return first == inline_data(); }
+
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > cap) reallocate(new_cap);
+    }
+
+    // Moves the elements back inside the object when they fit.
+    void shrink_to_fit()
+    {
+        if (is_inline() || count == cap) return;
+        if (count > N) {
+            reallocate(count);
+            return;
+        }
+        pointer p = inline_data(), q = p;
+        try {
+            for (pointer i = first; i != first + count; ++i, ++q) {
+                construct(q, std::move_if_noexcept(*i));
+            }
+        }
+        catch (...) {
+            destroy(p, q);
+            throw;
+        }
+        destroy(first, first + count);
+        deallocate();
+        first = p;
+    }
+
+    void clear() noexcept
+    {
+        destroy(first, first + count);
+        count = 0;
+    }
+
+    void push_back(const value_type& val) { emplace_back(val); }
+    void push_back(value_type&& val) { emplace_back(std::move(val)); }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (count == cap) {
+            // args may refer to an element, so the new one is constructed
+            // before the old ones are moved away.
+            size_type new_cap = grown(count + 1);
+            pointer p = AllocTraits::allocate(alloc(), new_cap);
+            try {
+                construct(p + count, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                AllocTraits::deallocate(alloc(), p, new_cap);
+                throw;
+            }
+            relocate_to(p, new_cap, 1);
+        }
+        else construct(first + count, std::forward<Args>(args)...);
+        return first[count++];
+    }
+
+    void pop_back()
+    {
+        AllocTraits::destroy(alloc(), first + --count);
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_type off = pos - cbegin();
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(first + off, first + count - 1, first + count);
+        return first + off;
+    }
+
+    iterator insert(const_iterator pos, const value_type& value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+    iterator insert(const_iterator pos, size_type n, const value_type& value)
+    {
+        value_type tmp(value);
+        size_type off = pos - cbegin();
+        reserve_grown(count + n);
+        for (size_type i = 0; i < n; ++i) emplace_back(tmp);
+        std::rotate(first + off, first + count - n, first + count);
+        return first + off;
+    }
+    template<typename InputIt,
+             typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt from, InputIt to)
+    {
+        size_type off = pos - cbegin(), old = count;
+        append(from, to, typename std::iterator_traits<InputIt>::iterator_category());
+        std::rotate(first + off, first + old, first + count);
+        return first + off;
+    }
+    iterator insert(const_iterator pos, std::initializer_list<value_type> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator from, const_iterator to)
+    {
+        pointer f = first + (from - cbegin()), t = first + (to - cbegin());
+        if (f != t) {
+            pointer nl = std::move(t, first + count, f);
+            destroy(nl, first + count);
+            count = nl - first;
+        }
+        return f;
+    }
+
+    void resize(size_type n)
+    {
+        if (n <= count) destroy_back(n);
+        else {
+            reserve_grown(n);
+            while (count < n) emplace_back();
+        }
+    }
+    void resize(size_type n, const value_type& value)
+    {
+        if (n <= count) destroy_back(n);
+        else {
+            value_type tmp(value);
+            reserve_grown(n);
+            while (count < n) emplace_back(tmp);
+        }
+    }
+
+    // Heap buffers are swapped, inline elements are moved.
+    void swap(Self& other)
+    {
+        if (!is_inline() && !other.is_inline()) {
+            using std::swap;
+            swap(alloc(), other.alloc());
+            swap(first, other.first);
+            swap(count, other.count);
+            swap(cap, other.cap);
+        }
+        else {
+            Self tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+    }
+
+private:
+
+    pointer first;
+    size_type count;
+    size_type cap;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[N];
+
+    Alloc& alloc() noexcept { return *this; }
+    const Alloc& alloc() const noexcept { return *this; }
+
+    pointer inline_data() noexcept { return reinterpret_cast<pointer>(buf); }
+    const_pointer inline_data() const noexcept { return reinterpret_cast<const_pointer>(buf); }
+
+    template<class... Args>
+    void construct(pointer p, Args&&... args)
+    {
+        AllocTraits::construct(alloc(), p, std::forward<Args>(args)...);
+    }
+
+    void destroy(pointer from, pointer to) noexcept
+    {
+        for (; from != to; ++from) AllocTraits::destroy(alloc(), from);
+    }
+
+    void destroy_back(size_type n) noexcept
+    {
+        destroy(first + n, first + count);
+        count = n;
+    }
+
+    void deallocate() noexcept
+    {
+        if (!is_inline()) AllocTraits::deallocate(alloc(), first, cap);
+        first = inline_data(), cap = N;
+    }
+
+    // Takes the heap buffer of `other`, or moves its inline elements. This
+    // one is empty and inline.
+    void steal(Self& other)
+    {
+        if (other.is_inline()) {
+            for (size_type i = 0; i < other.count; ++i, ++count) {
+                construct(first + i, std::move(other.first[i]));
+            }
+            other.clear();
+        }
+        else {
+            first = other.first, count = other.count, cap = other.cap;
+            other.first = other.inline_data(), other.count = 0, other.cap = N;
+        }
+    }
+
+    size_type grown(size_type need) const
+    {
+        if (need > max_size()) throw std::length_error("SmallVector: too many elements");
+        return std::max(2 * cap, need);
+    }
+
+    void reserve_grown(size_type need)
+    {
+        if (need > cap) reallocate(grown(need));
+    }
+
+    void reallocate(size_type new_cap)
+    {
+        relocate_to(AllocTraits::allocate(alloc(), new_cap), new_cap, 0);
+    }
+
+    // Moves the elements to the new buffer `p` of `new_cap` slots, where
+    // `constructed` slots after them already hold elements.
+    void relocate_to(pointer p, size_type new_cap, size_type constructed)
+    {
+        pointer q = p;
+        try {
+            for (pointer i = first; i != first + count; ++i, ++q) {
+                construct(q, std::move_if_noexcept(*i));
+            }
+        }
+        catch (...) {
+            destroy(p, q);
+            destroy(p + count, p + count + constructed);
+            AllocTraits::deallocate(alloc(), p, new_cap);
+            throw;
+        }
+        destroy(first, first + count);
+        deallocate();
+        first = p, cap = new_cap;
+    }
+
+    template<typename InputIt>
+    void append(InputIt from, InputIt to, std::input_iterator_tag)
+    {
+        for (; from != to; ++from) emplace_back(*from);
+    }
+
+    template<typename ForwardIt>
+    void append(ForwardIt from, ForwardIt to, std::forward_iterator_tag)
+    {
+        reserve_grown(count + std::distance(from, to));
+        pointer p = first + count;
+        try {
+            for (; from != to; ++from, ++p) construct(p, *from);
+        }
+        catch (...) {
+            destroy(first + count, p);
+            throw;
+        }
+        count = p - first;
+    }
+
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("SmallVector::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
+};
+
+template<typename T, std::size_t N, typename Alloc>
+void swap(SmallVector<T, N, Alloc>& lhs, SmallVector<T, N, Alloc>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+// A Deque whose blocks are SmallVectors: each of them holds N elements
+// inline, so a deque of at most N elements never allocates, wherever they
+// were pushed. The object is about 2 * N * sizeof(T) bytes larger.
+template<typename T, std::size_t N, typename RebuildPolicy = HalfRebuild>
+using SmallDeque = Deque<T, SmallVector<T, N>, RebuildPolicy>;
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::SmallDeque.");
+
+#endif
+
+}
+
+#endif
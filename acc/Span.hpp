@@ -0,0 +1,50 @@
+// A minimal non-owning view of contiguous elements. Subset of <span>.
+
+#ifndef _ACC_SPAN
+#define _ACC_SPAN
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace acc
+{
+
+template<typename T>
+class Span
+{
+
+public:
+
+    typedef T                                           element_type;
+    typedef typename std::remove_cv<T>::type            value_type;
+    typedef std::size_t                                 size_type;
+    typedef std::ptrdiff_t                              difference_type;
+    typedef T*                                          pointer;
+    typedef T&                                          reference;
+    typedef T*                                          iterator;
+    typedef std::reverse_iterator<iterator>             reverse_iterator;
+
+    constexpr Span() noexcept: ptr(nullptr), len(0) { }
+    constexpr Span(pointer _p, size_type _n) noexcept: ptr(_p), len(_n) { }
+
+    constexpr pointer data() const noexcept { return ptr; }
+    constexpr size_type size() const noexcept { return len; }
+    constexpr bool empty() const noexcept { return len == 0; }
+    constexpr reference operator[](size_type pos) const { return ptr[pos]; }
+
+    constexpr iterator begin() const noexcept { return ptr; }
+    constexpr iterator end() const noexcept { return ptr + len; }
+    reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+private:
+
+    pointer ptr;
+    size_type len;
+
+};
+
+}
+
+#endif
@@ -0,0 +1,227 @@
+// A bounded single-producer single-consumer queue.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+
+#ifndef _ACC_SPSC_QUEUE
+#define _ACC_SPSC_QUEUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+#ifndef ACC_CACHE_LINE
+#define ACC_CACHE_LINE 64
+#endif
+
+// A ring buffer of a power-of-two capacity shared by exactly one producer
+// thread, which calls the try_push functions, and one consumer thread, which
+// calls the try_pop functions. Neither ever blocks or takes a lock.
+//
+// `tail` is written by the producer only and `head` by the consumer only;
+// both count up forever and are masked on access. Publishing an index is a
+// release store and reading the other side's index an acquire load, so the
+// elements it covers are visible. Each side also keeps the last value it saw
+// of the other index and reloads it only when the cached value says the
+// queue is full (or empty), so in the common case a side touches only its
+// own cache line. The two sides live on different cache lines.
+template<typename T, typename Alloc = std::allocator<T>>
+class SpscQueue
+{
+
+private:
+
+    typedef SpscQueue<T, Alloc> Self;
+    typedef std::allocator_traits<Alloc> AllocTraits;
+
+public:
+
+    typedef T                                           value_type;
+    typedef Alloc                                       allocator_type;
+    typedef std::size_t                                 size_type;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef typename AllocTraits::pointer               pointer;
+
+    // The capacity is rounded up to a power of two.
+    explicit SpscQueue(size_type capacity, const allocator_type& alloc = allocator_type())
+        : alloc(alloc)
+    {
+        if (capacity == 0) throw std::length_error("SpscQueue: zero capacity");
+        size_type cap = 1;
+        while (cap < capacity) cap <<= 1;
+        mask = cap - 1;
+        buf = AllocTraits::allocate(this->alloc, cap);
+    }
+
+    SpscQueue(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+    ~SpscQueue()
+    {
+        size_type h = head.load(std::memory_order_relaxed);
+        size_type t = tail.load(std::memory_order_relaxed);
+        for (; h != t; ++h) AllocTraits::destroy(alloc, std::addressof(buf[h & mask]));
+        AllocTraits::deallocate(alloc, buf, mask + 1);
+    }
+
+    size_type capacity() const noexcept { return mask + 1; }
+
+    // Exact when called from either side while the other one is idle,
+    // otherwise a snapshot that may already be stale.
+    size_type size() const noexcept
+    {
+        size_type t = tail.load(std::memory_order_acquire);
+        return t - head.load(std::memory_order_acquire);
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    // Producer side.
+
+    template<class... Args>
+    bool try_emplace(Args&&... args)
+    {
+        size_type t = tail.load(std::memory_order_relaxed);
+        if (t - head_cache > mask) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t - head_cache > mask) return false;
+        }
+        AllocTraits::construct(alloc, std::addressof(buf[t & mask]),
+                               std::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    bool try_push(const value_type& val) { return try_emplace(val); }
+    bool try_push(value_type&& val) { return try_emplace(std::move(val)); }
+
+    // Pushes as many of the `n` elements starting at `first` as fit and
+    // publishes them at once. Returns how many were pushed.
+    template<typename InputIt>
+    size_type try_push_n(InputIt first, size_type n)
+    {
+        size_type t = tail.load(std::memory_order_relaxed);
+        if (mask + 1 - (t - head_cache) < n) head_cache = head.load(std::memory_order_acquire);
+        n = std::min(n, mask + 1 - (t - head_cache));
+        size_type i = 0;
+        try {
+            for (; i < n; ++i, ++first) {
+                AllocTraits::construct(alloc, std::addressof(buf[(t + i) & mask]), *first);
+            }
+        }
+        catch (...) {
+            tail.store(t + i, std::memory_order_release);
+            throw;
+        }
+        if (n) tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side.
+
+    // Moves the first element into `out`.
+    bool try_pop(value_type& out)
+    {
+        size_type h = head.load(std::memory_order_relaxed);
+        if (h == tail_cache) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h == tail_cache) return false;
+        }
+        pointer p = std::addressof(buf[h & mask]);
+        out = std::move(*p);
+        AllocTraits::destroy(alloc, p);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // The first element, or nullptr when the queue looks empty. It stays
+    // valid until pop().
+    value_type* front()
+    {
+        size_type h = head.load(std::memory_order_relaxed);
+        if (h == tail_cache) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h == tail_cache) return nullptr;
+        }
+        return std::addressof(buf[h & mask]);
+    }
+
+    // Removes the first element, which must exist (see front()).
+    void pop()
+    {
+        size_type h = head.load(std::memory_order_relaxed);
+        AllocTraits::destroy(alloc, std::addressof(buf[h & mask]));
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // Moves up to `n` elements to `out` and frees their slots at once.
+    // Returns how many were popped.
+    template<typename OutputIt>
+    size_type try_pop_n(OutputIt out, size_type n)
+    {
+        size_type h = head.load(std::memory_order_relaxed);
+        if (tail_cache - h < n) tail_cache = tail.load(std::memory_order_acquire);
+        n = std::min(n, tail_cache - h);
+        size_type i = 0;
+        try {
+            for (; i < n; ++i, ++out) {
+                pointer p = std::addressof(buf[(h + i) & mask]);
+                *out = std::move(*p);
+                AllocTraits::destroy(alloc, p);
+            }
+        }
+        catch (...) {
+            // The element that failed to move is still constructed.
+            head.store(h + i, std::memory_order_release);
+            throw;
+        }
+        if (n) head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+
+    // Producer line.
+    alignas(ACC_CACHE_LINE) std::atomic<size_type> tail{0};
+    size_type head_cache = 0;
+
+    // Consumer line.
+    alignas(ACC_CACHE_LINE) std::atomic<size_type> head{0};
+    size_type tail_cache = 0;
+
+    // Read-only after construction.
+    alignas(ACC_CACHE_LINE) pointer buf;
+    size_type mask;
+    allocator_type alloc;
+
+};
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::SpscQueue.");
+
+#endif
+
+}
+
+#endif
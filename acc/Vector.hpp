@@ -2,15 +2,26 @@
 #define _ACC_VECTOR
 
 #include <vector>
+#include <memory>
 #include <cstddef>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <initializer_list>
+#include <iterator>
 
 #include "AccBit.hpp"
-#include "IndexingIterator.hpp"
 
 namespace acc
 {
 
+// A vector made of blocks whose sizes are powers of two: block 0 holds
+// position 0, and block k (k >= 1) holds positions [2^(k-1), 2^k). Growth
+// only allocates the next block, so elements are never moved and references
+// stay valid until the element is erased.
 template<typename T, typename Alloc = std::allocator<T>>
 class Vector
 {
@@ -21,7 +32,101 @@ private:
 
 public:
 
-    DERIVE_ACC_INDEXING_ITERATOR(_Iterator, at_unsafe)
+    // Walks the blocks directly: the iterator caches the element pointer and
+    // the end of the current block, and only looks up the block table when it
+    // crosses a block boundary or jumps. Growth does not invalidate it, except
+    // for an iterator at a position that had no block yet (such as end() of a
+    // full vector).
+    template<typename Ref, typename Ptr>
+    class _Iterator
+    {
+    private:
+
+        typedef _Iterator<Ref, Ptr> Iter;
+
+    public:
+        typedef T                                           value_type;
+        typedef std::size_t                                 size_type;
+        typedef std::ptrdiff_t                              difference_type;
+        typedef Ref                                         reference;
+        typedef Ptr                                         pointer;
+        typedef std::random_access_iterator_tag             iterator_category;
+
+        difference_type cur;
+        Self* s;
+        pointer p;
+        pointer blk_end;
+
+        _Iterator(): cur(), s(nullptr), p(), blk_end() { }
+        _Iterator(difference_type _c, Self* _s): cur(_c), s(_s) { load(); }
+        _Iterator(difference_type _c, const Self* _s): cur(_c), s(const_cast<Self*>(_s))
+        {
+            load();
+        }
+        template<typename _Iter, typename = typename std::enable_if<
+            std::is_same<Iter, _Iterator<const T&, typename Self::const_pointer>>::value
+            && std::is_same<_Iter, _Iterator<T&, typename Self::pointer>>::value>::type>
+        _Iterator(const _Iter& __x): cur(__x.cur), s(__x.s), p(__x.p), blk_end(__x.blk_end) { }
+        _Iterator(const _Iterator& __x) = default;
+        _Iterator& operator=(const _Iterator& t) = default;
+
+        reference operator*() const { return *p; }
+        pointer operator->() const { return p; }
+        reference operator[](difference_type n) const { return *((*this) + n); }
+
+        Iter& operator++()
+        {
+            ++cur;
+            if (++p == blk_end) load();
+            return *this;
+        }
+        Iter operator++(int)
+        {
+            Iter copy = *this;
+            ++(*this);
+            return copy;
+        }
+        Iter& operator--()
+        {
+            // Blocks start at 0 and at the powers of two.
+            if ((cur & (cur - 1)) == 0) --cur, load();
+            else --cur, --p;
+            return *this;
+        }
+        Iter operator--(int)
+        {
+            Iter copy = *this;
+            --(*this);
+            return copy;
+        }
+        Iter& operator+=(difference_type n) { cur += n; load(); return *this; }
+        Iter& operator-=(difference_type n) { cur -= n; load(); return *this; }
+        Iter operator+(difference_type n) const { return Iter(cur + n, s); }
+        friend Iter operator+(difference_type n, const Iter& th) { return th + n; }
+        Iter operator-(difference_type n) const { return Iter(cur - n, s); }
+        difference_type operator-(const Iter& t) const { return cur - t.cur; }
+
+        bool operator==(const Iter& t) const { return cur == t.cur && s == t.s; }
+        bool operator!=(const Iter& t) const { return !(*this == t); }
+        bool operator<(const Iter& t) const { return cur < t.cur; }
+        bool operator>(const Iter& t) const { return t < *this; }
+        bool operator>=(const Iter& t) const { return !(*this < t); }
+        bool operator<=(const Iter& t) const { return !(t < *this); }
+
+    private:
+
+        void load()
+        {
+            size_type pos = static_cast<size_type>(cur);
+            if (s == nullptr || pos >= s->capacity()) {
+                p = blk_end = pointer();
+                return;
+            }
+            size_type k = acc::bit_width(pos);
+            p = s->head()[k] + (pos - block_begin(k));
+            blk_end = s->head()[k] + block_size(k);
+        }
+    };
 
     typedef T                                           value_type;
     typedef Alloc                                       allocator_type;
@@ -45,73 +150,272 @@ public:
 
 public:
 
+    Vector() = default;
+    explicit Vector(const allocator_type& alloc): vec_impl(alloc) { }
+    Vector(size_type count, const value_type& value,
+        const allocator_type& alloc = allocator_type()): vec_impl(alloc)
+    {
+        resize(count, value);
+    }
+    explicit Vector(size_type count, const allocator_type& alloc = allocator_type())
+        : vec_impl(alloc)
+    {
+        resize(count);
+    }
+    template<typename InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    Vector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
+        : vec_impl(alloc)
+    {
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    Vector(const Self& other)
+        : vec_impl(AllocVal::select_on_container_copy_construction(other.get_allocator()))
+    {
+        reserve(other.size());
+        for (const auto& x: other) push_back(x);
+    }
+    Vector(Self&& other) noexcept: vec_impl(std::move(other.vec_impl)) { }
+    Vector(std::initializer_list<value_type> init,
+        const allocator_type& alloc = allocator_type())
+        : Vector(init.begin(), init.end(), alloc) { }
+
+    ~Vector()
+    {
+        clear();
+        release(0);
+    }
+
+    Self& operator=(const Self& other)
+    {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    Self& operator=(Self&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            release(0);
+            static_cast<allocator_type&>(vec_impl) = std::move(other.vec_impl);
+            vec_impl.steal(other.vec_impl);
+        }
+        return *this;
+    }
+    Self& operator=(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    template<typename InputIt, typename = typename
+        std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        for (; first != last; ++first) emplace_back(*first);
+    }
+    void assign(size_type count, const value_type& value)
+    {
+        clear();
+        resize(count, value);
+    }
+    void assign(std::initializer_list<value_type> ilist)
+    {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type(vec_impl);
+    }
+
+    reference operator[](size_type pos) { return *at_unsafe(pos); }
+    const_reference operator[](size_type pos) const
+    {
+        return *const_cast<Self*>(this)->at_unsafe(pos);
+    }
+
+    reference at(size_type pos)
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+        range_check(pos);
+        return (*this)[pos];
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    iterator begin() { return iterator(0, this); }
+    const_iterator begin() const { return const_iterator(0, this); }
+    const_iterator cbegin() const { return const_iterator(0, this); }
+    iterator end() { return iterator(size(), this); }
+    const_iterator end() const { return const_iterator(size(), this); }
+    const_iterator cend() const { return const_iterator(size(), this); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+
     constexpr size_type size() const noexcept
     {
         return vec_impl.size;
     }
 
+    bool empty() const noexcept { return size() == 0; }
+
+    size_type max_size() const noexcept
+    {
+        return std::min<size_type>(AllocVal::max_size(vec_impl),
+            size_type(1) << (std::numeric_limits<size_type>::digits - 1));
+    }
+
+    size_type capacity() const noexcept
+    {
+        return block_begin(vec_impl.blocks);
+    }
+
+    void reserve(size_type new_cap)
+    {
+        if (new_cap > max_size()) {
+            throw std::length_error("Vector::reserve");
+        }
+        while (capacity() < new_cap) expand();
+    }
+
+    // Frees the blocks after the one holding the last element.
+    void shrink_to_fit()
+    {
+        release(size() == 0 ? 0 : acc::bit_width(size() - 1) + 1);
+    }
+
+    void clear() noexcept
+    {
+        while (size()) pop_back();
+    }
+
     void push_back(const value_type& x)
     {
-        if ((size() & -size()) == size()) { // 0 or 1 << x
-            expand();
+        emplace_back(x);
+    }
+    void push_back(value_type&& x)
+    {
+        emplace_back(std::move(x));
+    }
+
+    template<class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (size() == capacity()) expand();
+        pointer p = at_unsafe(size());
+        AllocVal::construct(vec_impl, std::addressof(*p), std::forward<Args>(args)...);
+        ++vec_impl.size;
+        return *p;
+    }
+
+    void pop_back()
+    {
+        --vec_impl.size;
+        AllocVal::destroy(vec_impl, std::addressof(*at_unsafe(size())));
+    }
+
+    void resize(size_type count)
+    {
+        reserve(count);
+        while (size() < count) emplace_back();
+        while (size() > count) pop_back();
+    }
+    void resize(size_type count, const value_type& value)
+    {
+        reserve(count);
+        while (size() < count) push_back(value);
+        while (size() > count) pop_back();
+    }
+
+    // Calls f(p, n) for each block in order, where [p, p + n) are elements.
+    // The chunks are contiguous, so loops inside `f` can be vectorized.
+    template<typename Func>
+    void for_each_segment(Func f)
+    {
+        for (size_type k = 0; block_begin(k) < size(); ++k) {
+            f(head()[k], std::min(block_size(k), size() - block_begin(k)));
+        }
+    }
+    template<typename Func>
+    void for_each_segment(Func f) const
+    {
+        for (size_type k = 0; block_begin(k) < size(); ++k) {
+            f(const_pointer(head()[k]), std::min(block_size(k), size() - block_begin(k)));
         }
-        *at_unsafe(size()++) = x;
     }
 
-    allocator_type get_allocator()
+    void swap(Self& other) noexcept
     {
-        return allocator_type(vec_impl);
+        using std::swap;
+        swap(static_cast<allocator_type&>(vec_impl),
+             static_cast<allocator_type&>(other.vec_impl));
+        swap(static_cast<_VecData&>(vec_impl), static_cast<_VecData&>(other.vec_impl));
     }
 
 private:
 
 
-    typedef typename AllocVal::rebind_traits<pointer> AllocPtr;
+    typedef typename AllocVal::template rebind_traits<pointer> AllocPtr;
+    typedef typename AllocVal::template rebind_alloc<pointer> PtrAlloc;
 
     struct _VecData
     {
         pointer* head;
         size_type size;
+        size_type blocks;
 
-        constexpr _VecData() noexcept : head(), size() { }
+        constexpr _VecData() noexcept : head(), size(), blocks() { }
 
-        constexpr
         _VecData(_VecData&& __x) noexcept
-            : head(__x.head), size(__x.size)
-        { 
-            __x.head = (__x.size = pointer()); 
+            : head(__x.head), size(__x.size), blocks(__x.blocks)
+        {
+            __x.head = nullptr;
+            __x.size = __x.blocks = 0;
+        }
+
+        _VecData& operator=(const _VecData&) = default;
+
+        void steal(_VecData& __x) noexcept
+        {
+            head = __x.head, size = __x.size, blocks = __x.blocks;
+            __x.head = nullptr;
+            __x.size = __x.blocks = 0;
         }
 
     };
 
     struct _VecImpl : allocator_type, _VecData
     {
-        constexpr _VecImpl() noexcept(
+        _VecImpl() noexcept(
             std::is_nothrow_default_constructible<allocator_type>::value)
         : allocator_type()
         { }
 
-        constexpr
         _VecImpl(allocator_type const& __a) noexcept
             : allocator_type(__a)
         { }
 
-        constexpr
         _VecImpl(_VecImpl&& __x) noexcept
             : allocator_type(std::move(__x)), _VecData(std::move(__x))
         { }
 
-        constexpr
         _VecImpl(allocator_type&& __a) noexcept
             : allocator_type(std::move(__a))
         { }
-
-        constexpr
-        _VecImpl(allocator_type&& __a, _VecImpl&& __rv) noexcept
-            : allocator_type(std::move(__a)), _VecData(std::move(__rv))
-        { }
     };
-    
+
     _VecImpl vec_impl;
 
     constexpr pointer* head() const noexcept
@@ -119,23 +423,58 @@ private:
         return vec_impl.head;
     }
 
+    // First position held by block k, which is also the total capacity of
+    // the blocks before it.
+    static constexpr size_type block_begin(size_type k) noexcept
+    {
+        return k == 0 ? 0 : size_type(1) << (k - 1);
+    }
+
+    static constexpr size_type block_size(size_type k) noexcept
+    {
+        return k == 0 ? 1 : size_type(1) << (k - 1);
+    }
+
+    // Allocates the next block. Only the small array of block pointers is
+    // reallocated, the elements stay where they are.
     void expand()
     {
-        size_type head_size = acc::bit_width(size());
-        allocator_type alloc = get_allocator();
-        pointer* temp = AllocPtr::allocate(alloc, head_size + 1ull);
+        size_type head_size = vec_impl.blocks;
+        PtrAlloc ptr_alloc(vec_impl);
+        pointer* temp = AllocPtr::allocate(ptr_alloc, head_size + 1);
+        try {
+            temp[head_size] = AllocVal::allocate(vec_impl, block_size(head_size));
+        }
+        catch (...) {
+            AllocPtr::deallocate(ptr_alloc, temp, head_size + 1);
+            throw;
+        }
         for (size_type i = 0; i < head_size; ++i) {
-            AllocPtr::construct(alloc, temp + i, *(size() + i));
-            AllocPtr::destroy(alloc, head() + i);
+            temp[i] = head()[i];
         }
-        if (size() == 0ull) {
-            AllocPtr::construct(alloc, temp + head_size, AllocVal::allocate(alloc, 1ull));
+        if (head_size != 0) {
+            AllocPtr::deallocate(ptr_alloc, head(), head_size);
         }
-        else {
-            AllocPtr::construct(alloc, temp + head_size, AllocVal::allocate(alloc, size()));
-            AllocPtr::deallocate(alloc, head(), head_size);
+        vec_impl.head = temp;
+        vec_impl.blocks = head_size + 1;
+    }
+
+    // Frees all blocks from the k-th on. The caller destroys their elements.
+    void release(size_type k)
+    {
+        if (k >= vec_impl.blocks) return;
+        PtrAlloc ptr_alloc(vec_impl);
+        for (size_type i = k; i < vec_impl.blocks; ++i) {
+            AllocVal::deallocate(vec_impl, head()[i], block_size(i));
         }
-        head() = temp;
+        pointer* temp = nullptr;
+        if (k != 0) {
+            temp = AllocPtr::allocate(ptr_alloc, k);
+            for (size_type i = 0; i < k; ++i) temp[i] = head()[i];
+        }
+        AllocPtr::deallocate(ptr_alloc, head(), vec_impl.blocks);
+        vec_impl.head = temp;
+        vec_impl.blocks = k;
     }
 
     pointer at_unsafe(size_type pos)
@@ -143,9 +482,44 @@ private:
         return head()[acc::bit_width(pos)] + (pos - acc::bit_floor(pos));
     }
 
+    void range_check(size_type pos) const
+    {
+        if (pos >= size())
+        {
+            throw std::out_of_range("Vector::range_check: pos "
+                       "(which is " + std::to_string(pos) +
+                       ") >= this->size() (which is " +
+                       std::to_string(this->size()) + ")");
+        }
+    }
+
 };
 
+template<typename T, typename Alloc>
+void swap(Vector<T, Alloc>& lhs, Vector<T, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template<typename T, typename Alloc>
+bool operator==(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename T, typename Alloc>
+bool operator!=(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template<typename T, typename Alloc>
+bool operator<(const Vector<T, Alloc>& lhs, const Vector<T, Alloc>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
 }
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,192 @@
+// A Chase-Lev work-stealing deque.
+
+// Copyright (C) 2024 Robin Ye (robinyqc@163.com).
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <type_traits>
+
+#ifndef _ACC_WORK_STEALING_DEQUE
+#define _ACC_WORK_STEALING_DEQUE
+
+namespace acc
+{
+
+#if __cplusplus >= 201103L
+
+#ifndef ACC_CACHE_LINE
+#define ACC_CACHE_LINE 64
+#endif
+
+// One owner thread pushes and pops at the bottom, any number of thieves
+// steal from the top (Chase and Lev, "Dynamic circular work-stealing
+// deque", with the orderings of Le et al., "Correct and efficient
+// work-stealing for weak memory models").
+//
+// Elements live in a circular array indexed by `top` and `bottom`, which only
+// grow (top) or move by one (bottom). Only the owner writes bottom and the
+// array; top is advanced by CAS, by a thief or by the owner taking the last
+// element. The store of bottom in pop() and the load of it in steal() are
+// sequentially consistent, which is what the full fences of the paper are
+// for, so that the owner and a thief can not both take the last element.
+//
+// A full array is replaced by one twice as large. Thieves may still read the
+// old one, so it is kept until the deque is destroyed, which costs at most
+// as much memory as the current array.
+//
+// Thieves read a slot before they know whether they own it, so the slots are
+// atomics and T has to be trivially copyable; store pointers or indices to
+// larger tasks.
+template<typename T>
+class WorkStealingDeque
+{
+
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "WorkStealingDeque needs a trivially copyable element type.");
+
+private:
+
+    typedef WorkStealingDeque<T> Self;
+    typedef std::int64_t Index;
+
+    struct Array
+    {
+        Index mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(Index capacity)
+            : mask(capacity - 1), slots(new std::atomic<T>[capacity]) { }
+
+        Index capacity() const { return mask + 1; }
+        T get(Index i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(Index i, T x) { slots[i & mask].store(x, std::memory_order_relaxed); }
+    };
+
+public:
+
+    typedef T               value_type;
+    typedef std::size_t     size_type;
+
+    // The capacity is rounded up to a power of two; it only grows.
+    explicit WorkStealingDeque(size_type capacity = 64)
+    {
+        Index cap = 1;
+        while (cap < Index(capacity)) cap <<= 1;
+        arrays.emplace_back(new Array(cap));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const Self&) = delete;
+    Self& operator=(const Self&) = delete;
+
+    // A snapshot, exact only when no other thread is working on the deque.
+    size_type size() const noexcept
+    {
+        Index b = bottom.load(std::memory_order_relaxed);
+        Index t = top.load(std::memory_order_relaxed);
+        return b > t ? size_type(b - t) : 0;
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    size_type capacity() const noexcept
+    {
+        return size_type(array.load(std::memory_order_relaxed)->capacity());
+    }
+
+    // Owner only.
+    void push(T x)
+    {
+        Index b = bottom.load(std::memory_order_relaxed);
+        Index t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > a->mask) a = grow(a, t, b);
+        a->put(b, x);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only. Takes the most recently pushed element; false when the
+    // deque is empty.
+    bool pop(T& out)
+    {
+        Index b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_seq_cst);
+        Index t = top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = a->get(b);
+        if (t == b) {
+            // The last element, a thief may be after it as well.
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Takes the least recently pushed element; false when the
+    // deque is empty or another thread took that element first.
+    bool steal(T& out)
+    {
+        Index t = top.load(std::memory_order_seq_cst);
+        Index b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) return false;
+        Array* a = array.load(std::memory_order_acquire);
+        T x = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return false;
+        }
+        out = x;
+        return true;
+    }
+
+private:
+
+    // Written by the thieves and, rarely, the owner.
+    alignas(ACC_CACHE_LINE) std::atomic<Index> top{0};
+
+    // Written by the owner only.
+    alignas(ACC_CACHE_LINE) std::atomic<Index> bottom{0};
+    std::atomic<Array*> array{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays;
+
+    Array* grow(Array* a, Index t, Index b)
+    {
+        arrays.emplace_back(new Array(2 * a->capacity()));
+        Array* n = arrays.back().get();
+        for (Index i = t; i != b; ++i) n->put(i, a->get(i));
+        array.store(n, std::memory_order_release);
+        return n;
+    }
+
+};
+
+#else
+
+static_assert(false, "Require C++11 or later for acc::WorkStealingDeque.");
+
+#endif
+
+}
+
+#endif
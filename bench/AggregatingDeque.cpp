@@ -0,0 +1,110 @@
+// Sliding-window maximum of long long values: every event pushes a value,
+// pops the oldest once the window holds n values, and queries the maximum
+// of the window; 2n events per round. acc::AggregatingDeque (QueueRebuild
+// and HalfRebuild) against the monotonic std::deque that only works for
+// min/max, and against folding the whole window on each query (n <= 10000
+// only). ns_per_op is per event.
+//
+//     g++ -O2 -std=c++17 bench/AggregatingDeque.cpp -o aggregating_deque
+//     ./aggregating_deque 10000000 > result.csv
+
+#include <deque>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/AggregatingDeque.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+typedef long long Value;
+
+std::vector<Value> values(std::size_t n)
+{
+    Rng rng;
+    std::vector<Value> res(n);
+    for (Value& v: res) v = Value(rng() >> 1);
+    return res;
+}
+
+template<typename Policy>
+struct Aggregating
+{
+    acc::AggregatingDeque<Value, acc::MaxMonoid<Value>, Policy> dq;
+
+    void push(Value v) { dq.push_back(v); }
+    void pop() { dq.pop_front(); }
+    std::size_t size() const { return dq.size(); }
+    Value query() const { return dq.query(); }
+};
+
+// Keeps the decreasing maxima of the window with their positions.
+struct Monotonic
+{
+    std::deque<std::pair<std::size_t, Value>> dq;
+    std::size_t pushed = 0, popped = 0;
+
+    void push(Value v)
+    {
+        while (!dq.empty() && dq.back().second <= v) dq.pop_back();
+        dq.emplace_back(pushed++, v);
+    }
+    void pop()
+    {
+        if (dq.front().first == popped++) dq.pop_front();
+    }
+    std::size_t size() const { return pushed - popped; }
+    Value query() const { return dq.front().second; }
+};
+
+struct Fold
+{
+    std::deque<Value> dq;
+
+    void push(Value v) { dq.push_back(v); }
+    void pop() { dq.pop_front(); }
+    std::size_t size() const { return dq.size(); }
+    Value query() const
+    {
+        acc::MaxMonoid<Value> op;
+        Value res = op.identity();
+        for (Value v: dq) res = op(res, v);
+        return res;
+    }
+};
+
+template<typename W>
+void suite(Options& opt, const char* name, std::size_t max_window)
+{
+    for (std::size_t n: sizes(opt)) {
+        if (n > max_window) break;
+        run(opt, name, "slide", n, [n] { return values(2 * n); },
+            [](std::vector<Value>& v, std::size_t n) {
+                W w;
+                Value sum = 0;
+                for (Value x: v) {
+                    w.push(x);
+                    if (w.size() > n) w.pop();
+                    sum += w.query();
+                }
+                do_not_optimize(sum);
+                return v.size();
+            });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    opt.min_size = 100;
+    suite<Aggregating<acc::QueueRebuild>>(opt, "acc::AggregatingDeque", std::size_t(-1));
+    suite<Aggregating<acc::HalfRebuild>>(opt, "acc::AggregatingDeque/HalfRebuild",
+        std::size_t(-1));
+    suite<Monotonic>(opt, "std::deque/monotonic", std::size_t(-1));
+    suite<Fold>(opt, "std::deque/fold", 10000);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// A request-scoped workload: every request builds a few deques and a vector,
+// works on them and drops them. Compares the global heap with a pool kept
+// across requests and with an arena on a stack buffer released after every
+// request. The last CSV column counts calls of the global operator new per
+// request.
+//
+//     g++ -O2 -std=c++17 bench/Allocator.cpp -o allocator
+//     ./allocator [max_size] [filter] > result.csv
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/Allocator.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/Vector.hpp"
+
+using namespace acc::bench;
+
+void* operator new(std::size_t n)
+{
+    ++counter();
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+
+struct Empty { };
+
+Empty nothing() { return Empty(); }
+
+constexpr std::size_t queues_per_request = 4;
+
+// One request with `n` elements spread over its containers.
+template<typename Alloc>
+void request(std::size_t n, Rng& rng, const Alloc& alloc)
+{
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<int> IntAlloc;
+    typedef acc::Deque<int, std::vector<int, IntAlloc>> Dq;
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Dq> DqAlloc;
+    IntAlloc a(alloc);
+    std::vector<Dq, DqAlloc> queues{DqAlloc(alloc)};
+    queues.reserve(queues_per_request);
+    for (std::size_t i = 0; i < queues_per_request; i++) queues.emplace_back(a);
+    acc::Vector<int, IntAlloc> log(a);
+    long long sum = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        Dq& q = queues[rng() % queues_per_request];
+        switch (rng() % 4) {
+            case 0: q.push_front(int(i)); break;
+            case 1: if (!q.empty()) sum += q.front(), q.pop_front(); break;
+            default: q.push_back(int(i)); break;
+        }
+        if (i % 8 == 0) log.push_back(int(sum));
+    }
+    do_not_optimize(sum);
+    do_not_optimize(log.size());
+}
+
+void suite(Options& opt)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, "std::allocator", "request", n, nothing, [](Empty&, std::size_t n) {
+            Rng rng(n);
+            for (std::size_t r = 0; r < 100; r++) request(n, rng, std::allocator<int>());
+            return std::size_t(100);
+        });
+
+        run(opt, "acc::Pool", "request", n, nothing, [](Empty&, std::size_t n) {
+            static acc::Pool pool;
+            Rng rng(n);
+            for (std::size_t r = 0; r < 100; r++) {
+                request(n, rng, acc::PoolAllocator<int>(&pool));
+            }
+            return std::size_t(100);
+        });
+
+        run(opt, "acc::MonotonicArena", "request", n, nothing, [](Empty&, std::size_t n) {
+            static char buf[1 << 16];
+            static acc::MonotonicArena arena(buf, sizeof(buf));
+            Rng rng(n);
+            for (std::size_t r = 0; r < 100; r++) {
+                request(n, rng, acc::ArenaAllocator<int>(&arena));
+                arena.release();
+            }
+            return std::size_t(100);
+        });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    opt.max_size = std::min<std::size_t>(opt.max_size, 100000);
+    suite(opt);
+    return 0;
+}
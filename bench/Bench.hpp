@@ -0,0 +1,181 @@
+// A tiny self-contained benchmark harness for the acc containers.
+
+// Every case prints one CSV line:
+//     container,workload,size,ops,ns_per_op,peak_rss_kb,counter_per_op
+// A case may count anything (element moves, allocations) into counter();
+// the last column is that count divided by the number of operations.
+// On POSIX systems each case runs in a forked child, so the peak RSS
+// reported belongs to that case alone.
+
+#ifndef _ACC_BENCH
+#define _ACC_BENCH
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ACC_BENCH_FORK
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace acc
+{
+namespace bench
+{
+
+template<typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline std::uint64_t& counter()
+{
+    static std::uint64_t value = 0;
+    return value;
+}
+
+// Deterministic pseudo random numbers, cheap enough to call in a hot loop.
+struct Rng
+{
+    std::uint64_t state;
+
+    explicit Rng(std::uint64_t seed = 0x9e3779b97f4a7c15ull): state(seed) { }
+
+    std::uint64_t operator()()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+struct Options
+{
+    std::size_t min_size = 10;
+    std::size_t max_size = 1000000;
+    double min_seconds = 0.05;
+    std::string filter;
+    bool header = true;
+};
+
+// Usage: <bench> [max_size] [filter]
+// Only cases whose "container,workload" contains `filter` are run.
+inline Options parse_options(int argc, char** argv)
+{
+    Options opt;
+    if (argc > 1) opt.max_size = std::strtoull(argv[1], nullptr, 10);
+    if (argc > 2) opt.filter = argv[2];
+    return opt;
+}
+
+inline std::vector<std::size_t> sizes(const Options& opt)
+{
+    std::vector<std::size_t> res;
+    for (std::size_t n = opt.min_size; n <= opt.max_size; n *= 10) res.push_back(n);
+    return res;
+}
+
+// Repeats `round(n)` until `min_seconds` have passed; `round` returns the
+// number of operations it performed. Returns nanoseconds per operation and
+// stores the total operation count in `ops`.
+template<typename Round>
+double measure(const Options& opt, std::size_t n, Round&& round, std::size_t& ops)
+{
+    typedef std::chrono::steady_clock Clock;
+    ops = 0;
+    Clock::duration total{};
+    do {
+        Clock::time_point start = Clock::now();
+        ops += round(n);
+        total += Clock::now() - start;
+    } while (std::chrono::duration<double>(total).count() < opt.min_seconds);
+    return std::chrono::duration<double, std::nano>(total).count() / double(ops);
+}
+
+inline void print_header(Options& opt)
+{
+    if (opt.header) {
+        std::printf("container,workload,size,ops,ns_per_op,peak_rss_kb,counter_per_op\n");
+        std::fflush(stdout);
+        opt.header = false;
+    }
+}
+
+// Runs one case. `make()` builds the state outside of the timed region and
+// `round(state, n)` is the timed part.
+template<typename Make, typename Round>
+void run(Options& opt, const char* container, const char* workload,
+         std::size_t n, Make&& make, Round&& round)
+{
+    std::string name = std::string(container) + "," + workload;
+    if (name.find(opt.filter) == std::string::npos) return;
+    print_header(opt);
+
+#ifdef ACC_BENCH_FORK
+    int fds[2];
+    if (pipe(fds) == 0) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            auto state = make();
+            std::size_t ops;
+            counter() = 0;
+            double ns = measure(opt, n, [&](std::size_t k) { return round(state, k); }, ops);
+            char buf[64];
+            int len = std::snprintf(buf, sizeof(buf), "%zu,%.3f,%.3f", ops, ns,
+                                    double(counter()) / double(ops));
+            if (write(fds[1], buf, len) != len) _exit(1);
+            _exit(0);
+        }
+        close(fds[1]);
+        char buf[64] = {};
+        ssize_t len = pid > 0 ? read(fds[0], buf, sizeof(buf) - 1) : -1;
+        close(fds[0]);
+        int status = 0;
+        struct rusage usage;
+        std::memset(&usage, 0, sizeof(usage));
+        if (pid > 0) wait4(pid, &status, 0, &usage);
+        if (len <= 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::printf("%s,%zu,0,nan,0,nan\n", name.c_str(), n);
+        }
+        else {
+            // buf is "ops,ns_per_op,counter_per_op", the RSS goes in between.
+            char* last = std::strrchr(buf, ',');
+            *last = '\0';
+            std::printf("%s,%zu,%s,%ld,%s\n", name.c_str(), n, buf, long(usage.ru_maxrss),
+                        last + 1);
+        }
+        std::fflush(stdout);
+        return;
+    }
+#endif
+
+    auto state = make();
+    std::size_t ops;
+    counter() = 0;
+    double ns = measure(opt, n, [&](std::size_t k) { return round(state, k); }, ops);
+    std::printf("%s,%zu,%zu,%.3f,0,%.3f\n", name.c_str(), n, ops, ns,
+                double(counter()) / double(ops));
+    std::fflush(stdout);
+}
+
+}
+}
+
+#endif
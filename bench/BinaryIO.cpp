@@ -0,0 +1,97 @@
+// Checkpoints of an acc::Deque<long long> to a file and back: the text
+// operator<< and operator>> against save_binary, load_binary and opening a
+// MappedDequeView. The file goes to $TMPDIR (or /tmp) and is mostly served
+// from the page cache, so the numbers are the CPU cost, not the disk's.
+// ns_per_op is per element; "map" opens the view and reads one element.
+//
+//     g++ -O2 -std=c++17 bench/BinaryIO.cpp -o binary_io
+//     ./binary_io [max_size] [filter] > result.csv
+
+#define USE_EXTRA_ACC_DEQUE_OPT
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/BinaryIO.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+typedef acc::Deque<long long> Dq;
+
+std::string file_path()
+{
+    const char* dir = std::getenv("TMPDIR");
+    return std::string(dir ? dir : "/tmp") + "/acc_binary_io_bench_" + std::to_string(::getpid());
+}
+
+Dq filled(std::size_t n)
+{
+    Rng rng;
+    Dq dq;
+    for (std::size_t i = 0; i < n; i++) {
+        if (i & 1) dq.push_front((long long)(rng()));
+        else dq.push_back((long long)(rng()));
+    }
+    return dq;
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    std::string path = file_path();
+    for (std::size_t n: sizes(opt)) {
+        run(opt, "text", "save", n, [n] { return filled(n); }, [&path](Dq& dq, std::size_t n) {
+            std::ofstream out(path);
+            out << dq;
+            return n;
+        });
+        run(opt, "text", "load", n,
+            [n, &path] {
+                std::ofstream(path) << filled(n);
+                return Dq();
+            },
+            [&path](Dq& dq, std::size_t n) {
+                std::ifstream in(path);
+                dq.clear();
+                long long v;
+                while (in >> v) dq.push_back(v);
+                do_not_optimize(dq.back());
+                return n;
+            });
+        run(opt, "binary", "save", n, [n] { return filled(n); }, [&path](Dq& dq, std::size_t n) {
+            acc::save_binary(path, dq);
+            return n;
+        });
+        run(opt, "binary", "load", n,
+            [n, &path] {
+                acc::save_binary(path, filled(n));
+                return Dq();
+            },
+            [&path](Dq& dq, std::size_t n) {
+                acc::load_binary(path, dq);
+                do_not_optimize(dq.back());
+                return n;
+            });
+        run(opt, "binary", "map", n,
+            [n, &path] {
+                acc::save_binary(path, filled(n));
+                return 0;
+            },
+            [&path](int&, std::size_t n) {
+                acc::MappedDequeView<long long> view(path);
+                do_not_optimize(view[view.size() / 2]);
+                return n;
+            });
+    }
+    ::unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Filtering with bitsets: intersecting two masks, counting the result and
+// scanning its set bits, for acc::Bitset and acc::DynamicBitset against
+// std::bitset and std::vector<bool>. ns_per_op is per bit.
+//
+//     g++ -O2 -std=c++17 -mavx2 -mpopcnt bench/Bitset.cpp -o bitset
+//     ./bitset [max_size] [filter] > result.csv
+//
+// The fixed-size bitsets run at sizes up to `fixed_bits` only.
+
+#include <bitset>
+#include <memory>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/Bitset.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+constexpr std::size_t fixed_bits = 1 << 20;
+
+// Masks with about one bit in `sparsity` set.
+template<typename F>
+void random_bits(std::size_t n, unsigned sparsity, std::uint64_t seed, F&& set)
+{
+    Rng rng(seed);
+    for (std::size_t i = 0; i < n; i++) {
+        if (rng() % sparsity == 0) set(i);
+    }
+}
+
+template<typename B>
+struct Masks
+{
+    B a, b;
+};
+
+template<typename B>
+void acc_suite(Options& opt, const char* name, B (*make)(std::size_t, unsigned, std::uint64_t))
+{
+    for (std::size_t n: sizes(opt)) {
+        auto dense = [n, make] { return Masks<B>{make(n, 2, 1), make(n, 2, 2)}; };
+        auto sparse = [n, make] { return Masks<B>{make(n, 64, 1), make(n, 2, 2)}; };
+        run(opt, name, "and", n, dense, [](Masks<B>& m, std::size_t n) {
+            B c = m.a;
+            c &= m.b;
+            do_not_optimize(c.data()[0]);
+            return n;
+        });
+        run(opt, name, "count", n, dense, [](Masks<B>& m, std::size_t n) {
+            do_not_optimize(m.a.count());
+            return n;
+        });
+        run(opt, name, "scan_sparse", n, sparse, [](Masks<B>& m, std::size_t n) {
+            std::size_t sum = 0;
+            for (std::size_t i = m.a.find_first(); i != B::npos; i = m.a.find_next(i)) sum += i;
+            do_not_optimize(sum);
+            return n;
+        });
+    }
+}
+
+std::vector<bool> make_vector(std::size_t n, unsigned sparsity, std::uint64_t seed)
+{
+    std::vector<bool> v(n);
+    random_bits(n, sparsity, seed, [&](std::size_t i) { v[i] = true; });
+    return v;
+}
+
+acc::DynamicBitset make_dynamic(std::size_t n, unsigned sparsity, std::uint64_t seed)
+{
+    acc::DynamicBitset v(n);
+    random_bits(n, sparsity, seed, [&](std::size_t i) { v.set(i); });
+    return v;
+}
+
+// The fixed-size ones are too large for the stack.
+struct StdFixed
+{
+    std::unique_ptr<std::bitset<fixed_bits>> p{new std::bitset<fixed_bits>};
+};
+
+struct AccFixed
+{
+    std::unique_ptr<acc::Bitset<fixed_bits>> p{new acc::Bitset<fixed_bits>};
+};
+
+void vector_suite(Options& opt)
+{
+    for (std::size_t n: sizes(opt)) {
+        auto dense = [n] { return Masks<std::vector<bool>>{make_vector(n, 2, 1), make_vector(n, 2, 2)}; };
+        auto sparse = [n] { return Masks<std::vector<bool>>{make_vector(n, 64, 1), make_vector(n, 2, 2)}; };
+        typedef Masks<std::vector<bool>> M;
+        run(opt, "std::vector<bool>", "and", n, dense, [](M& m, std::size_t n) {
+            std::vector<bool> c = m.a;
+            for (std::size_t i = 0; i < n; i++) c[i] = c[i] && m.b[i];
+            do_not_optimize(c.size());
+            return n;
+        });
+        run(opt, "std::vector<bool>", "count", n, dense, [](M& m, std::size_t n) {
+            std::size_t c = 0;
+            for (bool x: m.a) c += x;
+            do_not_optimize(c);
+            return n;
+        });
+        run(opt, "std::vector<bool>", "scan_sparse", n, sparse, [](M& m, std::size_t n) {
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < n; i++) {
+                if (m.a[i]) sum += i;
+            }
+            do_not_optimize(sum);
+            return n;
+        });
+    }
+}
+
+void fixed_suite(Options& opt)
+{
+    std::size_t n = fixed_bits;
+    if (n > opt.max_size) return;
+    auto std_state = [n] {
+        StdFixed a, b;
+        random_bits(n, 2, 1, [&](std::size_t i) { a.p->set(i); });
+        random_bits(n, 2, 2, [&](std::size_t i) { b.p->set(i); });
+        return std::make_pair(std::move(a), std::move(b));
+    };
+    auto acc_state = [n] {
+        AccFixed a, b;
+        random_bits(n, 2, 1, [&](std::size_t i) { a.p->set(i); });
+        random_bits(n, 2, 2, [&](std::size_t i) { b.p->set(i); });
+        return std::make_pair(std::move(a), std::move(b));
+    };
+    run(opt, "std::bitset", "and", n, std_state,
+        [](std::pair<StdFixed, StdFixed>& m, std::size_t n) {
+            *m.first.p &= *m.second.p;
+            do_not_optimize(*m.first.p);
+            return n;
+        });
+    run(opt, "std::bitset", "count", n, std_state,
+        [](std::pair<StdFixed, StdFixed>& m, std::size_t n) {
+            do_not_optimize(m.first.p->count());
+            return n;
+        });
+    run(opt, "acc::Bitset", "and", n, acc_state,
+        [](std::pair<AccFixed, AccFixed>& m, std::size_t n) {
+            *m.first.p &= *m.second.p;
+            do_not_optimize(m.first.p->data()[0]);
+            return n;
+        });
+    run(opt, "acc::Bitset", "count", n, acc_state,
+        [](std::pair<AccFixed, AccFixed>& m, std::size_t n) {
+            do_not_optimize(m.first.p->count());
+            return n;
+        });
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    opt.min_size = 1000;
+    vector_suite(opt);
+    acc_suite<acc::DynamicBitset>(opt, "acc::DynamicBitset", make_dynamic);
+    fixed_suite(opt);
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Producers pushing at the back and consumers popping at the front of one
+// shared deque: acc::ConcurrentDeque against a std::deque behind a single
+// mutex, from one pair of threads up to all hardware threads. ns_per_op is
+// per element passed through.
+//
+//     g++ -O2 -std=c++17 -pthread bench/ConcurrentDeque.cpp -o concurrent_deque
+//     ./concurrent_deque [max_size] [filter] > result.csv
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/ConcurrentDeque.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+struct Empty { };
+
+Empty nothing() { return Empty(); }
+
+struct Locked
+{
+    std::mutex m;
+    std::deque<int> dq;
+
+    void push_back(int x)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        dq.push_back(x);
+    }
+    bool try_pop_front(int& x)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (dq.empty()) return false;
+        x = dq.front();
+        dq.pop_front();
+        return true;
+    }
+};
+
+template<typename Q>
+std::size_t transfer(std::size_t n, unsigned pairs)
+{
+    Q q;
+    std::vector<std::thread> pool;
+    std::size_t share = n / pairs;
+    for (unsigned p = 0; p < pairs; p++) {
+        pool.emplace_back([&q, share] {
+            for (std::size_t i = 0; i < share; i++) q.push_back(int(i));
+        });
+        pool.emplace_back([&q, share] {
+            long long sum = 0;
+            int x;
+            for (std::size_t i = 0; i < share; ) {
+                if (q.try_pop_front(x)) sum += x, i++;
+                else std::this_thread::yield();
+            }
+            do_not_optimize(sum);
+        });
+    }
+    for (auto& t: pool) t.join();
+    return share * pairs;
+}
+
+template<typename Q>
+void suite(Options& opt, const char* name, const std::vector<unsigned>& counts)
+{
+    for (unsigned pairs: counts) {
+        std::string workload = "transfer_" + std::to_string(2 * pairs) + "_threads";
+        for (std::size_t n: sizes(opt)) {
+            run(opt, name, workload.c_str(), n, nothing,
+                [pairs](Empty&, std::size_t n) { return transfer<Q>(n, pairs); });
+        }
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    opt.min_size = 1000;
+    unsigned max_pairs = std::max(1u, std::thread::hardware_concurrency() / 2);
+    std::vector<unsigned> counts;
+    for (unsigned p = 1; p < max_pairs; p *= 2) counts.push_back(p);
+    counts.push_back(max_pairs);
+
+    suite<Locked>(opt, "mutex+std::deque", counts);
+    suite<acc::ConcurrentDeque<int>>(opt, "acc::ConcurrentDeque", counts);
+    suite<acc::ConcurrentDeque<int, std::vector<int>, acc::QueueRebuild>>(
+        opt, "acc::ConcurrentDeque<QueueRebuild>", counts);
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Throughput of the acc containers against the standard ones (and boost's
+// devector when it is available).
+//
+//     g++ -O2 -std=c++17 bench/Containers.cpp -o containers
+//     ./containers [max_size] [filter] > result.csv
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/DequeAlgorithm.hpp"
+#include "../acc/Devector.hpp"
+#include "../acc/RealtimeDeque.hpp"
+#include "../acc/Vector.hpp"
+
+#if defined(__has_include)
+#if __has_include(<boost/container/devector.hpp>)
+#include <boost/container/devector.hpp>
+#define ACC_BENCH_BOOST
+#endif
+#endif
+
+using namespace acc::bench;
+
+namespace
+{
+
+struct Empty { };
+
+Empty nothing() { return Empty(); }
+
+template<typename C>
+C filled(std::size_t n)
+{
+    C c;
+    for (std::size_t i = 0; i < n; i++) c.push_back(int(i));
+    return c;
+}
+
+// Middle insertion is quadratic, larger sizes would run for hours.
+constexpr std::size_t max_insert_size = 100000;
+
+template<typename C, bool Front, bool Insert>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, name, "push_back", n, nothing, [](Empty&, std::size_t n) {
+            C c;
+            for (std::size_t i = 0; i < n; i++) c.push_back(int(i));
+            do_not_optimize(c.back());
+            return n;
+        });
+
+        if constexpr (Front) {
+            run(opt, name, "push_front", n, nothing, [](Empty&, std::size_t n) {
+                C c;
+                for (std::size_t i = 0; i < n; i++) c.push_front(int(i));
+                do_not_optimize(c.front());
+                return n;
+            });
+
+            run(opt, name, "push_pop_mix", n, [n] { return filled<C>(n); },
+                [](C& c, std::size_t n) {
+                    Rng rng(n);
+                    for (std::size_t i = 0; i < n; i++) {
+                        switch (rng() & 3) {
+                            case 0: c.push_back(int(i)); break;
+                            case 1: c.push_front(int(i)); break;
+                            case 2: if (!c.empty()) c.pop_back(); break;
+                            default: if (!c.empty()) c.pop_front(); break;
+                        }
+                    }
+                    do_not_optimize(c.size());
+                    return n;
+                });
+
+            run(opt, name, "fifo", n, [n] { return filled<C>(n); },
+                [](C& c, std::size_t n) {
+                    for (std::size_t i = 0; i < n; i++) {
+                        c.push_back(int(i));
+                        c.pop_front();
+                    }
+                    do_not_optimize(c.front());
+                    return n;
+                });
+        }
+
+        run(opt, name, "random_access", n, [n] { return filled<C>(n); },
+            [](C& c, std::size_t n) {
+                Rng rng(n);
+                long long sum = 0;
+                for (std::size_t i = 0; i < n; i++) sum += c[rng() % n];
+                do_not_optimize(sum);
+                return n;
+            });
+
+        run(opt, name, "iterate", n, [n] { return filled<C>(n); },
+            [](C& c, std::size_t n) {
+                long long sum = 0;
+                for (int x: c) sum += x;
+                do_not_optimize(sum);
+                return n;
+            });
+
+        // Includes refilling the container with random values.
+        run(opt, name, "sort", n, [n] { return filled<C>(n); },
+            [](C& c, std::size_t n) {
+                Rng rng(n);
+                for (auto& x: c) x = int(rng());
+                std::sort(c.begin(), c.end());
+                do_not_optimize(c.front());
+                return n;
+            });
+
+        if constexpr (Insert) {
+            if (n > max_insert_size) continue;
+            run(opt, name, "middle_insert", n, nothing, [](Empty&, std::size_t n) {
+                C c;
+                for (std::size_t i = 0; i < n; i++) c.insert(c.begin() + c.size() / 2, int(i));
+                do_not_optimize(c.front());
+                return n;
+            });
+        }
+    }
+}
+
+// Sums an acc::Vector block by block instead of through its iterator.
+void vector_segments(Options& opt)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, "acc::Vector", "iterate_segments", n,
+            [n] { return filled<acc::Vector<int>>(n); },
+            [](acc::Vector<int>& c, std::size_t n) {
+                long long sum = 0;
+                c.for_each_segment([&sum](const int* p, std::size_t len) {
+                    for (std::size_t i = 0; i < len; i++) sum += p[i];
+                });
+                do_not_optimize(sum);
+                return n;
+            });
+    }
+}
+
+// Scans and sorts an acc::Deque whose elements are split evenly between its
+// two blocks, through its iterators and through acc/DequeAlgorithm.hpp.
+void deque_segments(Options& opt)
+{
+    typedef acc::Deque<int> D;
+    auto split = [](std::size_t n) {
+        D d;
+        for (std::size_t i = 0; i < n / 2; i++) d.push_front(int(i));
+        for (std::size_t i = n / 2; i < n; i++) d.push_back(int(i));
+        return d;
+    };
+    for (std::size_t n: sizes(opt)) {
+        auto make = [&split, n] { return split(n); };
+        run(opt, "acc::Deque", "range_for", n, make, [](D& d, std::size_t n) {
+            long long sum = 0;
+            for (int x: d) sum += x;
+            do_not_optimize(sum);
+            return n;
+        });
+        run(opt, "acc::Deque", "find_iterator", n, make, [](D& d, std::size_t n) {
+            do_not_optimize(std::find(d.begin(), d.end(), -1));
+            return n;
+        });
+        run(opt, "acc::Deque", "find_segments", n, make, [](D& d, std::size_t n) {
+            do_not_optimize(acc::find(d, -1));
+            return n;
+        });
+        run(opt, "acc::Deque", "accumulate_segments", n, make, [](D& d, std::size_t n) {
+            do_not_optimize(acc::accumulate(d, 0LL));
+            return n;
+        });
+        run(opt, "acc::Deque", "sort_iterator", n, make, [](D& d, std::size_t n) {
+            Rng rng(n);
+            for (auto& x: d) x = int(rng());
+            std::sort(d.begin(), d.end());
+            return n;
+        });
+        run(opt, "acc::Deque", "sort_segments", n, make, [](D& d, std::size_t n) {
+            Rng rng(n);
+            for (auto& x: d) x = int(rng());
+            acc::sort(d);
+            return n;
+        });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<std::vector<int>, false, true>(opt, "std::vector");
+    suite<std::deque<int>, true, true>(opt, "std::deque");
+    suite<acc::Vector<int>, false, false>(opt, "acc::Vector");
+    vector_segments(opt);
+    suite<acc::Deque<int>, true, true>(opt, "acc::Deque");
+    deque_segments(opt);
+    suite<acc::RealtimeDeque<int>, true, false>(opt, "acc::RealtimeDeque");
+    suite<acc::Devector<int>, true, true>(opt, "acc::Devector");
+#ifdef ACC_BENCH_BOOST
+    suite<boost::container::devector<int>, true, true>(opt, "boost::devector");
+#endif
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Comparison of two equal acc::Deques whose blocks are split at different
+// positions, against an element-wise loop through operator[] (the former
+// implementation) and std::deque. ns_per_op is per element.
+//
+//     g++ -O2 -std=c++17 bench/DequeCompare.cpp -o deque_compare
+//     ./deque_compare [max_size] [filter] > result.csv
+
+#include <deque>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+template<typename T>
+struct Pair
+{
+    acc::Deque<T> a, b;
+};
+
+// Equal contents, a third of `a` and half of `b` in the front block.
+template<typename T>
+Pair<T> pair(std::size_t n)
+{
+    Pair<T> p;
+    auto value = [](std::size_t i) { return T(i * 7 % 1000); };
+    for (std::size_t i = n / 3; i-- > 0;) p.a.push_front(value(i));
+    for (std::size_t i = n / 2; i-- > 0;) p.b.push_front(value(i));
+    for (std::size_t i = n / 3; i < n; i++) p.a.push_back(value(i));
+    for (std::size_t i = n / 2; i < n; i++) p.b.push_back(value(i));
+    return p;
+}
+
+template<typename T>
+bool indexed_equal(const acc::Deque<T>& a, const acc::Deque<T>& b)
+{
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); i++) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+template<typename T>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, name, "equal", n, [n] { return pair<T>(n); }, [](Pair<T>& p, std::size_t n) {
+            do_not_optimize(p.a == p.b);
+            return n;
+        });
+        run(opt, name, "three_way", n, [n] { return pair<T>(n); }, [](Pair<T>& p, std::size_t n) {
+            do_not_optimize(acc::three_way(p.a, p.b));
+            return n;
+        });
+        run(opt, name, "indexed_equal", n, [n] { return pair<T>(n); },
+            [](Pair<T>& p, std::size_t n) {
+                do_not_optimize(indexed_equal(p.a, p.b));
+                return n;
+            });
+        run(opt, name, "std::deque_equal", n,
+            [n] {
+                Pair<T> p = pair<T>(n);
+                return std::make_pair(std::deque<T>(p.a.begin(), p.a.end()),
+                                      std::deque<T>(p.b.begin(), p.b.end()));
+            },
+            [](std::pair<std::deque<T>, std::deque<T>>& p, std::size_t n) {
+                do_not_optimize(p.first == p.second);
+                return n;
+            });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<int>(opt, "int");
+    suite<double>(opt, "double");
+    return 0;
+}
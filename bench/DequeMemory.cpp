@@ -0,0 +1,100 @@
+// Memory held by many live deques of a few elements. Each round builds a
+// table of deques, pushes `size` elements into each, alternating between the
+// back and the front, and measures the bytes live on the heap. The last CSV
+// column is the number of bytes per deque: the object in the table plus
+// everything it allocated, including allocator overhead the program sees
+// (not that of malloc).
+//
+//     g++ -O2 -std=c++17 bench/DequeMemory.cpp -o deque_memory
+//     ./deque_memory [max_size] [filter] > result.csv
+
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/CompactDeque.hpp"
+#include "../acc/Devector.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+// Bytes currently allocated with the global operator new.
+std::size_t live_bytes = 0;
+
+// Keeps the size of every block in front of it.
+constexpr std::size_t prefix = alignof(std::max_align_t);
+
+}
+
+void* operator new(std::size_t n)
+{
+    char* p = static_cast<char*>(std::malloc(n + prefix));
+    if (p == nullptr) throw std::bad_alloc();
+    *reinterpret_cast<std::size_t*>(p) = n;
+    live_bytes += n;
+    return p + prefix;
+}
+
+void operator delete(void* p) noexcept
+{
+    if (p == nullptr) return;
+    char* q = static_cast<char*>(p) - prefix;
+    live_bytes -= *reinterpret_cast<std::size_t*>(q);
+    std::free(q);
+}
+
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+
+namespace
+{
+
+struct Empty { };
+
+Empty nothing() { return Empty(); }
+
+// Deques built per round.
+constexpr std::size_t deques = 10000;
+
+template<typename C>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t k: {0, 1, 16}) {
+        if (k > opt.max_size) break;
+
+        run(opt, name, "bytes_per_deque", k, nothing, [](Empty&, std::size_t k) {
+            std::size_t before = live_bytes;
+            {
+                std::vector<C> all;
+                all.reserve(deques);
+                for (std::size_t d = 0; d < deques; d++) {
+                    all.emplace_back();
+                    C& c = all.back();
+                    for (std::size_t i = 0; i < k; i++) {
+                        if (i & 1) c.push_front(int(i));
+                        else c.push_back(int(i));
+                    }
+                }
+                counter() += live_bytes - before;
+                do_not_optimize(all.back().size());
+            }
+            return deques;
+        });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<std::deque<int>>(opt, "std::deque");
+    suite<acc::Deque<int>>(opt, "acc::Deque");
+    suite<acc::CompactDeque<int>>(opt, "acc::CompactDeque");
+    suite<acc::Devector<int>>(opt, "acc::Devector");
+    return 0;
+}
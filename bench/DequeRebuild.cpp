@@ -0,0 +1,107 @@
+// Element moves and throughput of acc::Deque under its rebuild policies.
+// The last CSV column is the number of element moves per operation.
+//
+//     g++ -O2 -std=c++17 bench/DequeRebuild.cpp -o deque_rebuild
+//     ./deque_rebuild [max_size] [filter] > result.csv
+
+#include <deque>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+// An int that counts how often it is moved.
+struct Moved
+{
+    int value;
+
+    Moved(int v = 0): value(v) { }
+    Moved(const Moved& other) = default;
+    Moved(Moved&& other) noexcept: value(other.value) { ++counter(); }
+    Moved& operator=(const Moved& other) = default;
+    Moved& operator=(Moved&& other) noexcept
+    {
+        value = other.value;
+        ++counter();
+        return *this;
+    }
+};
+
+template<typename C>
+C filled(std::size_t n)
+{
+    C c;
+    for (std::size_t i = 0; i < n; i++) c.push_back(Moved(int(i)));
+    return c;
+}
+
+template<typename C>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t n: sizes(opt)) {
+        // Queue of constant length n.
+        run(opt, name, "fifo", n, [n] { return filled<C>(n); },
+            [](C& c, std::size_t n) {
+                for (std::size_t i = 0; i < n; i++) {
+                    c.push_back(Moved(int(i)));
+                    c.pop_front();
+                }
+                do_not_optimize(c.front().value);
+                return n;
+            });
+
+        // Queue that fills up to n and drains completely again.
+        run(opt, name, "fifo_burst", n, [] { return C(); },
+            [](C& c, std::size_t n) {
+                for (std::size_t i = 0; i < n; i++) c.push_back(Moved(int(i)));
+                for (std::size_t i = 0; i < n; i++) c.pop_front();
+                do_not_optimize(c.size());
+                return 2 * n;
+            });
+
+        // Random pushes and pops at both ends.
+        run(opt, name, "push_pop_mix", n, [n] { return filled<C>(n); },
+            [](C& c, std::size_t n) {
+                Rng rng(n);
+                for (std::size_t i = 0; i < n; i++) {
+                    switch (rng() & 3) {
+                        case 0: c.push_back(Moved(int(i))); break;
+                        case 1: c.push_front(Moved(int(i))); break;
+                        case 2: if (!c.empty()) c.pop_back(); break;
+                        default: if (!c.empty()) c.pop_front(); break;
+                    }
+                }
+                do_not_optimize(c.size());
+                return n;
+            });
+
+        // Stack at the back, popped from the back: no rebuild at all.
+        run(opt, name, "lifo", n, [n] { return filled<C>(n); },
+            [](C& c, std::size_t n) {
+                for (std::size_t i = 0; i < n; i++) {
+                    c.push_back(Moved(int(i)));
+                    c.pop_back();
+                }
+                do_not_optimize(c.size());
+                return n;
+            });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<std::deque<Moved>>(opt, "std::deque");
+    suite<acc::Deque<Moved>>(opt, "acc::Deque<HalfRebuild>");
+    suite<acc::Deque<Moved, std::vector<Moved>, acc::QueueRebuild>>(
+        opt, "acc::Deque<QueueRebuild>");
+    suite<acc::Deque<Moved, std::vector<Moved>, acc::AdaptiveRebuild>>(
+        opt, "acc::Deque<AdaptiveRebuild>");
+    return 0;
+}
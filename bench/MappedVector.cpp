@@ -0,0 +1,75 @@
+// acc::Deque on in-memory blocks against acc::MappedDeque, whose blocks are
+// files mapped into memory (in $TMPDIR or /tmp). While everything fits in
+// the page cache this measures the cost of the mapping itself: page faults
+// on growth and the remaps. ns_per_op is per element.
+//
+//     g++ -O2 -std=c++17 bench/MappedVector.cpp -o mapped_vector
+//     ./mapped_vector [max_size] [filter] > result.csv
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/MappedVector.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+template<typename C>
+C filled(std::size_t n)
+{
+    C c;
+    for (std::size_t i = 0; i < n; i++) {
+        if (i & 1) c.push_front((long long)(i));
+        else c.push_back((long long)(i));
+    }
+    return c;
+}
+
+template<typename C>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, name, "push_both", n, [] { return 0; }, [](int&, std::size_t n) {
+            C c = filled<C>(n);
+            do_not_optimize(c.back());
+            return n;
+        });
+
+        run(opt, name, "scan", n, [n] { return filled<C>(n); }, [](C& c, std::size_t n) {
+            long long sum = 0;
+            for (long long x: c) sum += x;
+            do_not_optimize(sum);
+            return n;
+        });
+
+        run(opt, name, "random_read", n, [n] { return filled<C>(n); },
+            [](C& c, std::size_t n) {
+                Rng rng;
+                long long sum = 0;
+                for (std::size_t i = 0; i < n; i++) sum += c[rng() % n];
+                do_not_optimize(sum);
+                return n;
+            });
+
+        // A FIFO queue: every pop from an empty front block rebuilds.
+        run(opt, name, "queue", n, [n] { return filled<C>(n); }, [](C& c, std::size_t n) {
+            for (std::size_t i = 0; i < n; i++) {
+                c.push_back(c.front());
+                c.pop_front();
+            }
+            do_not_optimize(c.back());
+            return n;
+        });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<acc::Deque<long long>>(opt, "acc::Deque");
+    suite<acc::MappedDeque<long long>>(opt, "acc::MappedDeque");
+    return 0;
+}
@@ -0,0 +1,148 @@
+// The parallel algorithms of acc/ParallelAlgorithm.hpp on an acc::Deque of
+// ints, from one thread up to all hardware threads, next to the serial
+// algorithms of acc/DequeAlgorithm.hpp. ns_per_op is per element.
+//
+//     g++ -O2 -std=c++17 -pthread bench/Parallel.cpp -o parallel
+//     ./parallel [max_size] [filter] > result.csv
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/DequeAlgorithm.hpp"
+#include "../acc/ParallelAlgorithm.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+typedef acc::Deque<int> Dq;
+
+// A third of the elements in the front block.
+Dq filled(std::size_t n)
+{
+    Dq dq;
+    Rng rng(n);
+    for (std::size_t i = 0; i < n; i++) {
+        if (i % 3 == 0) dq.push_front(int(rng() >> 33));
+        else dq.push_back(int(rng() >> 33));
+    }
+    return dq;
+}
+
+// acc::ThreadPool is cache-line aligned, which a plain `new` honours only
+// from C++17 on, so the pool is allocated with posix_memalign.
+struct FreePool
+{
+    void operator()(acc::ThreadPool* p) const
+    {
+        p->~ThreadPool();
+        std::free(p);
+    }
+};
+
+typedef std::unique_ptr<acc::ThreadPool, FreePool> PoolPtr;
+
+PoolPtr make_pool(unsigned threads)
+{
+    void* mem = nullptr;
+    if (posix_memalign(&mem, alignof(acc::ThreadPool), sizeof(acc::ThreadPool)) != 0) {
+        throw std::bad_alloc();
+    }
+    try {
+        return PoolPtr(::new (mem) acc::ThreadPool(threads));
+    }
+    catch (...) {
+        std::free(mem);
+        throw;
+    }
+}
+
+struct State
+{
+    Dq dq, scratch;
+    std::vector<int> out;
+    PoolPtr pool;
+};
+
+void serial(Options& opt, std::size_t n)
+{
+    auto make = [n] { return State{filled(n), Dq(), std::vector<int>(n), nullptr}; };
+    run(opt, "serial", "sort", n, make, [](State& s, std::size_t n) {
+        s.scratch = s.dq;
+        acc::sort(s.scratch);
+        do_not_optimize(s.scratch.front());
+        return n;
+    });
+    run(opt, "serial", "reduce", n, make, [](State& s, std::size_t n) {
+        do_not_optimize(acc::accumulate(s.dq, 0ll));
+        return n;
+    });
+    run(opt, "serial", "transform", n, make, [](State& s, std::size_t n) {
+        std::transform(s.dq.begin(), s.dq.end(), s.out.begin(), [](int x) { return x * 3 + 1; });
+        do_not_optimize(s.out.front());
+        return n;
+    });
+    run(opt, "serial", "for_each", n, make, [](State& s, std::size_t n) {
+        for (int& x: s.dq.reversed_front_span()) x = x * 3 + 1;
+        for (int& x: s.dq.back_span()) x = x * 3 + 1;
+        do_not_optimize(s.dq.front());
+        return n;
+    });
+}
+
+void parallel(Options& opt, std::size_t n, unsigned t)
+{
+    std::string name = "parallel_" + std::to_string(t) + "_threads";
+    auto make = [n, t] {
+        return State{filled(n), Dq(), std::vector<int>(n), make_pool(t)};
+    };
+    run(opt, name.c_str(), "sort", n, make, [](State& s, std::size_t n) {
+        s.scratch = s.dq;
+        acc::parallel_sort(*s.pool, s.scratch);
+        do_not_optimize(s.scratch.front());
+        return n;
+    });
+    run(opt, name.c_str(), "reduce", n, make, [](State& s, std::size_t n) {
+        do_not_optimize(acc::parallel_reduce(*s.pool, s.dq, 0ll));
+        return n;
+    });
+    run(opt, name.c_str(), "transform", n, make, [](State& s, std::size_t n) {
+        acc::parallel_transform(*s.pool, s.dq, s.out.begin(), [](int x) { return x * 3 + 1; });
+        do_not_optimize(s.out.front());
+        return n;
+    });
+    run(opt, name.c_str(), "for_each", n, make, [](State& s, std::size_t n) {
+        acc::parallel_for_each(*s.pool, s.dq, [](int& x) { x = x * 3 + 1; });
+        do_not_optimize(s.dq.front());
+        return n;
+    });
+    run(opt, name.c_str(), "find_if", n, make, [](State& s, std::size_t n) {
+        auto it = acc::parallel_find_if(*s.pool, s.dq, [](int x) { return x < 0; });
+        do_not_optimize(it.cur);
+        return n;
+    });
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    opt.min_size = 100000;
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+    for (std::size_t n: sizes(opt)) {
+        serial(opt, n);
+        for (unsigned t: counts) parallel(opt, n, t);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// std::priority_queue (a binary heap on std::vector) against
+// acc::PriorityQueue with 2, 4 and 8 children per node, on long long keys.
+// "push_pop" pushes n random keys and pops them all, "pop_push" replaces the
+// top of a heap of n keys n times (a scheduler taking the next task and
+// putting it back with a new deadline), and "heapify" builds a heap of n
+// keys at once. ns_per_op is per element.
+//
+//     g++ -O2 -std=c++17 bench/PriorityQueue.cpp -o priority_queue
+//     ./priority_queue [max_size] [filter] > result.csv
+
+#include <queue>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/PriorityQueue.hpp"
+#include "../acc/Vector.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+typedef long long Key;
+
+std::vector<Key> keys(std::size_t n)
+{
+    Rng rng;
+    std::vector<Key> res(n);
+    for (Key& k: res) k = Key(rng() >> 1);
+    return res;
+}
+
+// A uniform interface over both queues.
+template<typename Q>
+void push_all(Q& q, const std::vector<Key>& v)
+{
+    for (Key k: v) q.push(k);
+}
+
+template<typename Q>
+void replace_top(Q& q, Key k)
+{
+    q.pop();
+    q.push(k);
+}
+
+template<typename T, typename C, typename Cont, std::size_t A>
+void replace_top(acc::PriorityQueue<T, C, Cont, A>& q, Key k)
+{
+    q.pop_push(k);
+}
+
+template<typename Q>
+Q heapify(const std::vector<Key>& v)
+{
+    return Q(v.begin(), v.end());
+}
+
+template<typename Q>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, name, "push_pop", n, [n] { return keys(n); },
+            [](std::vector<Key>& v, std::size_t n) {
+                Q q;
+                push_all(q, v);
+                Key sum = 0;
+                while (!q.empty()) sum += q.top(), q.pop();
+                do_not_optimize(sum);
+                return n;
+            });
+
+        run(opt, name, "pop_push", n,
+            [n] {
+                Q q;
+                push_all(q, keys(n));
+                return q;
+            },
+            [](Q& q, std::size_t n) {
+                Rng rng(n);
+                for (std::size_t i = 0; i < n; i++) {
+                    // Later deadlines, so the heap keeps mixing.
+                    replace_top(q, q.top() - Key(rng() >> 40));
+                }
+                do_not_optimize(q.top());
+                return n;
+            });
+
+        run(opt, name, "heapify", n, [n] { return keys(n); },
+            [](std::vector<Key>& v, std::size_t n) {
+                Q q = heapify<Q>(v);
+                do_not_optimize(q.top());
+                return n;
+            });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<std::priority_queue<Key>>(opt, "std::priority_queue");
+    suite<acc::PriorityQueue<Key, std::less<Key>,
+        std::vector<Key, acc::CacheAlignedAllocator<Key>>, 2>>(opt, "acc::PriorityQueue<2>");
+    suite<acc::PriorityQueue<Key>>(opt, "acc::PriorityQueue<4>");
+    suite<acc::PriorityQueue<Key, std::less<Key>,
+        std::vector<Key, acc::CacheAlignedAllocator<Key>>, 8>>(opt, "acc::PriorityQueue<8>");
+    suite<acc::PriorityQueue<Key, std::less<Key>, acc::Vector<Key>, 8>>(opt,
+        "acc::PriorityQueue<8>/acc::Vector");
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Growth and rebuilds of acc::Deque on std::vector against RelocVector,
+// which grows with realloc and rebuilds with memcpy for trivially
+// relocatable elements, for int, double and a 64-byte POD.
+//
+//     g++ -O2 -std=c++17 bench/Relocation.cpp -o relocation
+//     ./relocation [max_size] [filter] > result.csv
+
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/RelocVector.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+struct Pod64
+{
+    long long v[8];
+
+    Pod64(int x = 0): v{x} { }
+};
+
+template<typename C>
+void suite(Options& opt, const char* name)
+{
+    typedef typename C::value_type T;
+    for (std::size_t n: sizes(opt)) {
+        // Pushes from empty, all growth.
+        run(opt, name, "push_back", n, [] { return 0; }, [](int&, std::size_t n) {
+            C c;
+            for (std::size_t i = 0; i < n; i++) c.push_back(T(int(i)));
+            do_not_optimize(c.back());
+            return n;
+        });
+
+        // Pushes at the back and pops at the front, every pop from an empty
+        // front block rebuilds.
+        run(opt, name, "fifo_burst", n, [] { return C(); }, [](C& c, std::size_t n) {
+            for (std::size_t i = 0; i < n; i++) c.push_back(T(int(i)));
+            for (std::size_t i = 0; i < n; i++) c.pop_front();
+            do_not_optimize(c.size());
+            return 2 * n;
+        });
+
+        // Pushes at both ends and pops at the opposite one.
+        run(opt, name, "cross_pop", n, [] { return C(); }, [](C& c, std::size_t n) {
+            Rng rng(n);
+            for (std::size_t i = 0; i < n; i++) {
+                if (rng() & 1) c.push_back(T(int(i)));
+                else c.push_front(T(int(i)));
+            }
+            for (std::size_t i = 0; i < n; i++) {
+                if (rng() & 1) c.pop_back();
+                else c.pop_front();
+            }
+            do_not_optimize(c.size());
+            return 2 * n;
+        });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<acc::Deque<int>>(opt, "acc::Deque<int>");
+    suite<acc::RelocDeque<int>>(opt, "acc::RelocDeque<int>");
+    suite<acc::Deque<double>>(opt, "acc::Deque<double>");
+    suite<acc::RelocDeque<double>>(opt, "acc::RelocDeque<double>");
+    suite<acc::Deque<Pod64>>(opt, "acc::Deque<Pod64>");
+    suite<acc::RelocDeque<Pod64>>(opt, "acc::RelocDeque<Pod64>");
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Creation and destruction of many short deques, with and without inline
+// storage. The last CSV column is the number of allocations per deque; the
+// size column is the number of elements pushed into each deque.
+//
+//     g++ -O2 -std=c++17 bench/SmallDeque.cpp -o small_deque
+//     ./small_deque [max_size] [filter] > result.csv
+
+#include <deque>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/SmallDeque.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+template<typename T>
+struct CountingAlloc : std::allocator<T>
+{
+    template<typename U> struct rebind { typedef CountingAlloc<U> other; };
+
+    CountingAlloc() = default;
+    template<typename U> CountingAlloc(const CountingAlloc<U>&) { }
+
+    T* allocate(std::size_t n)
+    {
+        ++counter();
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+struct Empty { };
+
+Empty nothing() { return Empty(); }
+
+// Deques built per round.
+constexpr std::size_t rounds = 10000;
+
+template<typename C>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t k: {0, 1, 2, 4, 8, 16}) {
+        if (k > opt.max_size) break;
+
+        run(opt, name, "create_destroy", k, nothing, [](Empty&, std::size_t k) {
+            for (std::size_t r = 0; r < rounds; r++) {
+                C c;
+                for (std::size_t i = 0; i < k; i++) {
+                    if (i & 1) c.push_front(int(i));
+                    else c.push_back(int(i));
+                }
+                do_not_optimize(c.size());
+            }
+            return rounds;
+        });
+
+        // Many live deques at once, as in a table of small queues.
+        run(opt, name, "many_live", k, [] { return std::vector<C>(rounds); },
+            [](std::vector<C>& all, std::size_t k) {
+                for (C& c: all) {
+                    for (std::size_t i = 0; i < k; i++) c.push_back(int(i));
+                }
+                for (C& c: all) {
+                    while (!c.empty()) c.pop_front();
+                    c.shrink_to_fit();
+                }
+                do_not_optimize(all.front().size());
+                return rounds;
+            });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<std::deque<int, CountingAlloc<int>>>(opt, "std::deque");
+    suite<acc::Deque<int, std::vector<int, CountingAlloc<int>>>>(opt, "acc::Deque");
+    suite<acc::Deque<int, acc::SmallVector<int, 4, CountingAlloc<int>>>>(
+        opt, "acc::SmallDeque<4>");
+    suite<acc::Deque<int, acc::SmallVector<int, 8, CountingAlloc<int>>>>(
+        opt, "acc::SmallDeque<8>");
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Handing elements from one thread to another: acc::SpscQueue against an
+// acc::Deque behind a mutex. "transfer" is the throughput of a stream of n
+// elements, "ping_pong" the round trip latency of one element bounced between
+// two threads n times.
+//
+//     g++ -O2 -std=c++17 -pthread bench/SpscQueue.cpp -o spsc_queue
+//     ./spsc_queue [max_size] [filter] > result.csv
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/Deque.hpp"
+#include "../acc/SpscQueue.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+struct Empty { };
+
+Empty nothing() { return Empty(); }
+
+constexpr std::size_t queue_capacity = 1024;
+constexpr std::size_t batch_size = 64;
+
+// The two queues share an interface for the cases below. Failed tries
+// yield, so the cases make progress on a single core as well.
+struct Spsc
+{
+    acc::SpscQueue<int> q{queue_capacity};
+
+    void push(int x)
+    {
+        while (!q.try_push(x)) std::this_thread::yield();
+    }
+    int pop()
+    {
+        int x;
+        while (!q.try_pop(x)) std::this_thread::yield();
+        return x;
+    }
+};
+
+struct SpscBatched : Spsc
+{
+    void push_n(const int* p, std::size_t n)
+    {
+        while (n) {
+            std::size_t k = q.try_push_n(p, n);
+            if (k == 0) std::this_thread::yield();
+            p += k, n -= k;
+        }
+    }
+    std::size_t pop_n(int* out, std::size_t n)
+    {
+        std::size_t k;
+        while ((k = q.try_pop_n(out, n)) == 0) std::this_thread::yield();
+        return k;
+    }
+};
+
+struct Locked
+{
+    std::mutex m;
+    acc::Deque<int> dq;
+
+    void push(int x)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        dq.push_back(x);
+    }
+    int pop()
+    {
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if (!dq.empty()) {
+                    int x = dq.front();
+                    dq.pop_front();
+                    return x;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+};
+
+template<typename Q>
+void suite(Options& opt, const char* name)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, name, "transfer", n, nothing, [](Empty&, std::size_t n) {
+            Q q;
+            std::thread consumer([&] {
+                long long sum = 0;
+                for (std::size_t i = 0; i < n; i++) sum += q.pop();
+                do_not_optimize(sum);
+            });
+            for (std::size_t i = 0; i < n; i++) q.push(int(i));
+            consumer.join();
+            return n;
+        });
+
+        run(opt, name, "ping_pong", n, nothing, [](Empty&, std::size_t n) {
+            Q there, back;
+            std::thread echo([&] {
+                for (std::size_t i = 0; i < n; i++) back.push(there.pop());
+            });
+            for (std::size_t i = 0; i < n; i++) {
+                there.push(int(i));
+                do_not_optimize(back.pop());
+            }
+            echo.join();
+            return n;
+        });
+    }
+}
+
+void batched(Options& opt)
+{
+    for (std::size_t n: sizes(opt)) {
+        run(opt, "acc::SpscQueue", "transfer_batched", n, nothing,
+            [](Empty&, std::size_t n) {
+                SpscBatched q;
+                std::thread consumer([&] {
+                    int buf[batch_size];
+                    long long sum = 0;
+                    for (std::size_t got = 0; got < n; ) {
+                        std::size_t k = q.pop_n(buf, std::min(batch_size, n - got));
+                        for (std::size_t i = 0; i < k; i++) sum += buf[i];
+                        got += k;
+                    }
+                    do_not_optimize(sum);
+                });
+                std::vector<int> src(batch_size);
+                for (std::size_t i = 0; i < n; i += batch_size) {
+                    std::size_t k = std::min(batch_size, n - i);
+                    for (std::size_t j = 0; j < k; j++) src[j] = int(i + j);
+                    q.push_n(src.data(), k);
+                }
+                consumer.join();
+                return n;
+            });
+    }
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    suite<Spsc>(opt, "acc::SpscQueue");
+    batched(opt);
+    suite<Locked>(opt, "mutex+acc::Deque");
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Task throughput of a work-stealing scheduler built on
+// acc::WorkStealingDeque, from one thread up to all hardware threads. Each
+// round splits the range [0, n) in halves down to single elements, every
+// half being a task; ns_per_op is per task.
+//
+//     g++ -O2 -std=c++17 -pthread bench/WorkStealing.cpp -o work_stealing
+//     ./work_stealing [max_size] [filter] > result.csv
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.hpp"
+#include "../acc/WorkStealingDeque.hpp"
+
+using namespace acc::bench;
+
+namespace
+{
+
+struct Empty { };
+
+Empty nothing() { return Empty(); }
+
+struct Range
+{
+    std::uint32_t lo, hi;
+};
+
+typedef acc::WorkStealingDeque<Range> Queue;
+
+// One deque per thread, reused by every round: a round ends with all of them
+// empty. They are cache-line aligned, which static storage honours before
+// C++17 where a plain `new` does not.
+const unsigned max_threads = 64;
+Queue queues[max_threads];
+
+// Runs the round on `threads` threads, the calling one included. Returns the
+// number of tasks run.
+std::size_t split_round(std::size_t n, unsigned threads)
+{
+    std::atomic<std::size_t> left(n), tasks(0);
+
+    auto work = [&](unsigned i) {
+        Queue& own = queues[i];
+        std::size_t done = 0;
+        std::uint64_t sum = 0;
+        Rng rng(i + 1);
+        Range r;
+        while (left.load(std::memory_order_relaxed) != 0) {
+            if (!own.pop(r)) {
+                unsigned victim = unsigned(rng() % threads);
+                if (victim == i || !queues[victim].steal(r)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+            }
+            for (;;) {
+                ++done;
+                if (r.hi - r.lo == 1) break;
+                std::uint32_t mid = r.lo + (r.hi - r.lo) / 2;
+                own.push(Range{mid, r.hi});
+                r.hi = mid;
+            }
+            sum += r.lo;
+            left.fetch_sub(1, std::memory_order_relaxed);
+        }
+        do_not_optimize(sum);
+        tasks.fetch_add(done);
+    };
+
+    queues[0].push(Range{0, std::uint32_t(n)});
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) pool.emplace_back(work, i);
+    work(0);
+    for (auto& t: pool) t.join();
+    return tasks.load();
+}
+
+}
+
+signed main(int argc, char** argv)
+{
+    Options opt = parse_options(argc, argv);
+    unsigned threads = std::min(max_threads, std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<unsigned> counts;
+    for (unsigned t = 1; t < threads; t *= 2) counts.push_back(t);
+    counts.push_back(threads);
+    for (unsigned t: counts) {
+        std::string workload = "range_split_" + std::to_string(t) + "_threads";
+        for (std::size_t n: sizes(opt)) {
+            run(opt, "acc::WorkStealingDeque", workload.c_str(), n, nothing,
+                [t](Empty&, std::size_t n) { return split_round(n, t); });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/AggregatingDeque.hpp"
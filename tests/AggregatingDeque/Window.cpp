@@ -0,0 +1,88 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include "AggregatingDequeLink.hpp"
+
+// x -> a * x + b, composed left to right: not commutative, so the order of
+// the elements matters.
+struct Affine
+{
+    long long a, b;
+
+    bool operator==(const Affine& o) const { return a == o.a && b == o.b; }
+};
+
+struct Compose
+{
+    static constexpr long long mod = 1000000007;
+
+    Affine identity() const { return Affine{1, 0}; }
+    Affine operator()(const Affine& f, const Affine& g) const
+    {
+        return Affine{f.a * g.a % mod, (f.b * g.a + g.b) % mod};
+    }
+};
+
+// Random pushes and pops at both ends, checked against a fold of the deque.
+template<typename Dq, typename Make>
+std::size_t check(unsigned seed, Make make)
+{
+    typedef typename Dq::value_type T;
+    Dq dq;
+    std::deque<T> ref;
+    std::mt19937 rng(seed);
+    typename Dq::monoid_type op;
+    std::size_t mismatches = 0;
+    for (int i = 0; i < 20000; i++) {
+        unsigned r = rng() % 10;
+        T v = make(rng);
+        if (r < 4 || ref.empty()) dq.push_back(v), ref.push_back(v);
+        else if (r < 6) dq.push_front(v), ref.push_front(v);
+        else if (r < 8) dq.pop_front(), ref.pop_front();
+        else dq.pop_back(), ref.pop_back();
+
+        T expect = op.identity();
+        for (const T& x: ref) expect = op(expect, x);
+        if (dq.size() != ref.size() || !(dq.query() == expect)) ++mismatches;
+    }
+    if (!std::equal(ref.begin(), ref.end(), dq.begin())) ++mismatches;
+    return mismatches;
+}
+
+signed main()
+{
+    using std::cout;
+    auto number = [](std::mt19937& rng) { return int(rng() % 2001) - 1000; };
+    auto affine = [](std::mt19937& rng) {
+        return Affine{(long long)(rng() % 1000), (long long)(rng() % 1000)};
+    };
+    cout << check<acc::AggregatingDeque<long long>>(1, number) << '\n'; // 0
+    cout << check<acc::AggregatingDeque<int, acc::MinMonoid<int>>>(2, number) << '\n'; // 0
+    cout << check<acc::AggregatingDeque<int, acc::MaxMonoid<int>, acc::HalfRebuild>>(3, number)
+         << '\n'; // 0
+    cout << check<acc::AggregatingDeque<Affine, Compose>>(4, affine) << '\n'; // 0
+    cout << check<acc::AggregatingDeque<Affine, Compose, acc::AdaptiveRebuild>>(5, affine)
+         << '\n'; // 0
+
+    // A sliding window of 3.
+    acc::AggregatingDeque<double, acc::MaxMonoid<double>> window;
+    cout << window.query() << '\n'; // -inf
+    for (double x: {1.0, 5.0, 2.0, 0.5, 0.25, 3.0}) {
+        window.push_back(x);
+        if (window.size() > 3) window.pop_front();
+        cout << window.query() << ' ';
+    }
+    cout << '\n'; // 1 5 5 5 2 3
+
+    acc::AggregatingDeque<std::string> words{"a", "b"};
+    words.push_front("c");
+    cout << words.query() << ' ' << words.front() << ' ' << words[2] << '\n'; // cab c b
+    try {
+        words.at(3);
+    }
+    catch (const std::out_of_range&) {
+        cout << "out_of_range\n"; // out_of_range
+    }
+    return 0;
+}
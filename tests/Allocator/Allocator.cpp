@@ -0,0 +1,95 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+#include "../../acc/Deque.hpp"
+#include "../../acc/Vector.hpp"
+#include "AllocatorLink.hpp"
+
+template<typename T>
+using ArenaDeque = acc::Deque<T, std::vector<T, acc::ArenaAllocator<T>>>;
+template<typename T>
+using PoolDeque = acc::Deque<T, std::vector<T, acc::PoolAllocator<T>>>;
+
+template<typename Dq>
+std::size_t random_ops(Dq& dq, std::mt19937& rng)
+{
+    std::deque<std::string> ref;
+    std::size_t mismatches = 0;
+    for (int i = 0; i < 20000; i++) {
+        unsigned op = rng() % 4;
+        std::string s = std::to_string(i);
+        if (op == 0 || ref.empty()) dq.push_back(s), ref.push_back(s);
+        else if (op == 1) dq.push_front(s), ref.push_front(s);
+        else if (op == 2) dq.pop_back(), ref.pop_back();
+        else dq.pop_front(), ref.pop_front();
+    }
+    if (dq.size() != ref.size()) ++mismatches;
+    for (std::size_t i = 0; i < ref.size() && i < dq.size(); i++) mismatches += dq[i] != ref[i];
+    return mismatches;
+}
+
+signed main()
+{
+    using std::cout;
+    std::mt19937 rng(20241001);
+
+    // Per-request containers in an arena, freed together.
+    acc::MonotonicArena arena;
+    {
+        acc::ArenaAllocator<std::string> a(&arena);
+        ArenaDeque<std::string> dq(a);
+        cout << "mismatches: " << random_ops(dq, rng) << '\n'; // 0
+        acc::Vector<int, acc::ArenaAllocator<int>> v(&arena);
+        for (int i = 0; i < 1000; i++) v.push_back(i);
+        cout << v[999] << ' ' << (arena.upstream_bytes() > 0) << '\n'; // 999 1
+    }
+    arena.release();
+    cout << arena.upstream_bytes() << '\n'; // 0
+
+    // A buffer on the stack is used before any heap chunk.
+    alignas(16) char buf[1024];
+    acc::MonotonicArena local(buf, sizeof(buf));
+    {
+        std::vector<int, acc::ArenaAllocator<int>> v(&local);
+        v.reserve(100);
+        cout << (static_cast<void*>(v.data()) == buf) << ' '
+             << local.upstream_bytes() << '\n'; // 1 0
+    }
+
+    // The pool hands a freed block back out.
+    acc::Pool pool;
+    {
+        PoolDeque<std::string> dq{acc::PoolAllocator<std::string>(&pool)};
+        cout << "mismatches: " << random_ops(dq, rng) << '\n'; // 0
+    }
+    acc::PoolAllocator<long> p(&pool);
+    long* x = p.allocate(10);
+    p.deallocate(x, 10);
+    long* y = p.allocate(12); // 96 bytes, same 128-byte class
+    cout << (x == y) << '\n'; // 1
+    p.deallocate(y, 12);
+    acc::Vector<long, acc::PoolAllocator<long>> pv(p);
+    for (int i = 0; i < 5000; i++) pv.push_back(i);
+    cout << pv[4999] << '\n'; // 4999
+
+    // Moving a deque leaves the source on the global heap.
+    acc::MonotonicArena other;
+    ArenaDeque<std::string> m{acc::ArenaAllocator<std::string>(&other)};
+    m.push_back("moved");
+    ArenaDeque<std::string> n(std::move(m));
+    m.push_back("still fine");
+    cout << n.front() << ' ' << m.front() << '\n'; // moved still fine
+
+#ifdef _ACC_HAS_PMR
+    // The pool behind std::pmr containers.
+    acc::PmrResource<acc::Pool> pmr(&pool);
+    std::pmr::vector<int> pm(&pmr);
+    for (int i = 0; i < 100; i++) pm.push_back(i);
+    cout << pm.back() << '\n'; // 99
+#else
+    cout << 99 << '\n';
+#endif
+    return 0;
+}
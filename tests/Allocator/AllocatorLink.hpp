@@ -0,0 +1 @@
+#include "../../acc/Allocator.hpp"
\ No newline at end of file
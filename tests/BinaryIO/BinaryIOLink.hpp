@@ -0,0 +1 @@
+#include "../../acc/BinaryIO.hpp"
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include "BinaryIOLink.hpp"
+
+struct Point
+{
+    double x, y;
+    int id;
+};
+
+signed main()
+{
+    using std::cout;
+    std::string path = "/tmp/acc_binary_io_" + std::to_string(::getpid());
+
+    // Deques of every shape: empty, front block only, back block only, both.
+    std::size_t mismatches = 0;
+    std::mt19937 rng(20240701);
+    for (int round = 0; round < 50; round++) {
+        acc::Deque<long long> dq;
+        std::deque<long long> ref;
+        int n = round == 0 ? 0 : int(rng() % 5000);
+        int front = round % 3 == 0 ? n : int(rng() % (n + 1));
+        for (int i = 0; i < n; i++) {
+            long long v = (long long)(rng());
+            if (i < front) dq.push_front(v), ref.push_front(v);
+            else dq.push_back(v), ref.push_back(v);
+        }
+        acc::save_binary(path, dq);
+
+        acc::Deque<long long> loaded{1, 2, 3};
+        acc::load_binary(path, loaded);
+        if (loaded != dq) ++mismatches;
+
+        acc::MappedDequeView<long long> view(path);
+        if (view.size() != ref.size()) ++mismatches;
+        else if (!std::equal(ref.begin(), ref.end(), view.begin())) ++mismatches;
+        else if (!std::equal(ref.rbegin(), ref.rend(), view.rbegin())) ++mismatches;
+        for (std::size_t i = 0; i < ref.size(); i += 97) {
+            if (view[i] != ref[i]) ++mismatches;
+        }
+    }
+    cout << "mismatches: " << mismatches << '\n'; // mismatches: 0
+
+    // A Vector spans several blocks.
+    acc::Vector<Point> vec;
+    for (int i = 0; i < 1000; i++) vec.push_back(Point{i * 0.5, -i * 0.5, i});
+    acc::save_binary(path, vec);
+    acc::Vector<Point> back;
+    acc::load_binary(path, back);
+    acc::MappedDequeView<Point> points(path);
+    cout << back.size() << ' ' << back[999].id << ' ' << points.size() << ' '
+         << points.front().id << ' ' << points.back().x << '\n'; // 1000 999 1000 0 499.5
+
+    // Views move, and the file need not stay open.
+    acc::MappedDequeView<Point> moved(std::move(points));
+    cout << points.empty() << ' ' << moved[10].y << '\n'; // 1 -5
+    moved.advise(MADV_SEQUENTIAL);
+
+    // Files of another element type or truncated ones are rejected.
+    try {
+        acc::MappedDequeView<int> wrong(path);
+    }
+    catch (const std::runtime_error& e) {
+        cout << e.what() << '\n'; // acc::MappedDequeView: element type differs
+    }
+    if (::truncate(path.c_str(), 64 + 10 * sizeof(Point)) != 0) return 1;
+    try {
+        acc::load_binary(path, back);
+    }
+    catch (const std::runtime_error& e) {
+        cout << e.what() << '\n'; // acc::read_binary: truncated
+    }
+    try {
+        moved.at(1000);
+    }
+    catch (const std::out_of_range&) {
+        cout << "out_of_range\n"; // out_of_range
+    }
+    ::unlink(path.c_str());
+    try {
+        acc::MappedDequeView<Point> missing(path);
+    }
+    catch (const std::system_error&) {
+        cout << "system_error\n"; // system_error
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <bitset>
+#include <random>
+#include <vector>
+#include "BitsetLink.hpp"
+
+template<std::size_t N>
+std::size_t compare(const acc::Bitset<N>& a, const std::bitset<N>& b)
+{
+    std::size_t wrong = a.count() != b.count();
+    for (std::size_t i = 0; i < N; i++) wrong += a[i] != b[i];
+    return wrong;
+}
+
+template<std::size_t N>
+std::size_t random_ops(std::mt19937& rng)
+{
+    acc::Bitset<N> a, b;
+    std::bitset<N> ra, rb;
+    std::size_t wrong = 0;
+    for (int step = 0; step < 2000; step++) {
+        std::size_t pos = rng() % N, s = rng() % (N + 70);
+        switch (rng() % 10) {
+            case 0: a.set(pos), ra.set(pos); break;
+            case 1: b.flip(pos), rb.flip(pos); break;
+            case 2: a &= b, ra &= rb; break;
+            case 3: a |= b, ra |= rb; break;
+            case 4: a ^= b, ra ^= rb; break;
+            case 5: a.and_not(b), ra &= ~rb; break;
+            case 6: a <<= s, ra <<= s; break;
+            case 7: a >>= s, ra >>= s; break;
+            case 8: b = ~b, rb = ~rb; break;
+            default: a.reset(pos), ra.reset(pos); break;
+        }
+        wrong += compare(a, ra) + compare(b, rb);
+    }
+    return wrong;
+}
+
+signed main()
+{
+    using std::cout;
+    std::mt19937 rng(20240901);
+    cout << "wrong: " << random_ops<1>(rng) + random_ops<63>(rng) + random_ops<64>(rng)
+                       + random_ops<65>(rng) + random_ops<300>(rng) + random_ops<1024>(rng)
+         << '\n'; // 0
+
+    // Set bits are visited in increasing order.
+    acc::Bitset<200> f;
+    for (std::size_t i: {3, 64, 65, 127, 199}) f.set(i);
+    for (std::size_t i = f.find_first(); i != f.npos; i = f.find_next(i)) cout << i << ' ';
+    cout << '\n'; // 3 64 65 127 199
+    cout << acc::Bitset<8>("10110").to_string() << '\n'; // 00010110
+    cout << f.all() << ' ' << (~acc::Bitset<70>()).all() << '\n'; // 0 1
+
+    // The dynamic one against std::vector<bool>.
+    acc::DynamicBitset d(130, true);
+    std::vector<bool> rd(130, true);
+    std::size_t wrong = 0;
+    for (int step = 0; step < 2000; step++) {
+        std::size_t pos = rng() % rd.size();
+        switch (rng() % 5) {
+            case 0: d.flip(pos), rd[pos] = !rd[pos]; break;
+            case 1: d.push_back(step & 1), rd.push_back(step & 1); break;
+            case 2: {
+                std::size_t len = rng() % 300 + 1;
+                bool v = rng() & 1;
+                d.resize(len, v), rd.resize(len, v);
+                break;
+            }
+            case 3: d >>= pos, rd.erase(rd.begin(), rd.begin() + pos),
+                    rd.resize(d.size(), false); break;
+            default: d.reset(pos), rd[pos] = false; break;
+        }
+        std::size_t c = 0;
+        for (std::size_t i = 0; i < rd.size(); i++) wrong += d[i] != rd[i], c += rd[i];
+        wrong += d.count() != c || d.size() != rd.size();
+    }
+    cout << "wrong: " << wrong << '\n'; // 0
+
+    acc::DynamicBitset x(100), y(100);
+    x.set(10).set(90), y.set(90).set(50);
+    cout << (x & y).find_first() << ' ' << (x | y).count() << ' '
+         << (x ^ y).find_next(10) << ' ' << ((x << 20).find_next(30) == x.npos) << '\n'; // 90 3 50 1
+    try {
+        x.test(100);
+    }
+    catch (const std::out_of_range&) {
+        cout << "out of range\n"; // out of range
+    }
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/Bitset.hpp"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../acc/CompactDeque.hpp"
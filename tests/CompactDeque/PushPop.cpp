@@ -0,0 +1,70 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include "CompactDequeLink.hpp"
+
+signed main()
+{
+    using std::cout;
+    cout << (sizeof(acc::CompactDeque<int>) == sizeof(void*)) << '\n'; // 1
+    cout << (sizeof(acc::CompactDeque<int, std::allocator<int>, acc::AdaptiveRebuild>)
+             <= 3 * sizeof(void*)) << '\n'; // 1
+
+    acc::CompactDeque<std::string> dq;
+    std::deque<std::string> ref;
+    std::mt19937 rng(20240601);
+    std::size_t mismatches = 0;
+
+    for (int i = 0; i < 200000; i++) {
+        unsigned op = rng() % 8;
+        std::string s = std::to_string(i);
+        if (op < 3 || ref.empty()) dq.push_back(s), ref.push_back(s);
+        else if (op < 5) dq.push_front(s), ref.push_front(s);
+        else if (op < 6) dq.pop_back(), ref.pop_back();
+        else dq.pop_front(), ref.pop_front();
+        if (dq.size() != ref.size()) ++mismatches;
+        else if (!ref.empty() && (dq.front() != ref.front() || dq.back() != ref.back())) {
+            ++mismatches;
+        }
+        if (i % 20000 == 0 && !std::equal(ref.begin(), ref.end(), dq.begin())) ++mismatches;
+    }
+    for (std::size_t i = 0; i < ref.size(); i++) {
+        if (dq[i] != ref[i]) ++mismatches;
+    }
+    cout << "mismatches: " << mismatches << '\n'; // 0
+
+    // Drained, the deque goes back to the null pointer.
+    while (!dq.empty()) dq.pop_back();
+    dq.shrink_to_fit();
+    cout << dq.capacity() << '\n'; // 0
+
+    acc::CompactDeque<int> a({3, 4});
+    a.push_front(2), a.push_front(1);
+    acc::CompactDeque<int> b(a), c;
+    c = std::move(b);
+    c.pop_front();
+    for (auto it = c.rbegin(); it != c.rend(); ++it) cout << *it << ' ';
+    cout << '\n'; // 4 3 2
+    cout << (a == c) << ' ' << (c < a) << ' ' << b.empty() << '\n'; // 0 0 1
+
+    // Two integers are a count and a value, not an iterator range.
+    acc::CompactDeque<int> d(5, 3);
+    cout << d.size() << ' ' << d.back() << ' ';
+    d.assign(4, 2);
+    cout << d.size() << ' ' << d.front() << '\n'; // 5 3 4 2
+
+    // Pushing an element of the deque itself, also when that reallocates.
+    acc::CompactDeque<std::string> e;
+    e.push_back(std::string(40, 'x'));
+    e.push_back(e[0]), e.push_front(e.back()), e.push_back(e.front()), e.push_front(e[1]);
+    for (const auto& s: e) cout << s.size() << ' ';
+    cout << '\n'; // 40 40 40 40 40
+    try {
+        a.at(4);
+    }
+    catch (const std::out_of_range&) {
+        cout << "out_of_range\n"; // out_of_range
+    }
+    return 0;
+}
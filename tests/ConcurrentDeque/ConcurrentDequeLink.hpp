@@ -0,0 +1 @@
+#include "../../acc/ConcurrentDeque.hpp"
\ No newline at end of file
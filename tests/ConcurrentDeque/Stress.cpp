@@ -0,0 +1,86 @@
+// g++ -O2 -std=c++17 -pthread Stress.cpp (add -fsanitize=thread to check races)
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "ConcurrentDequeLink.hpp"
+
+template<typename Dq>
+std::size_t stress(int per_thread)
+{
+    // Two producers at each end, consumers at both ends with blocking and
+    // non-blocking pops. Every value must come out exactly once.
+    const int producers = 4, consumers = 4, total = producers * per_thread;
+    Dq dq;
+    std::vector<std::atomic<int>> taken(total);
+    for (auto& x: taken) x.store(0);
+    std::atomic<int> left(total);
+
+    std::vector<std::thread> pool;
+    for (int p = 0; p < producers; p++) {
+        pool.emplace_back([&, p] {
+            for (int i = p * per_thread; i < (p + 1) * per_thread; i++) {
+                if (p & 1) dq.push_front(i);
+                else dq.push_back(i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        pool.emplace_back([&, c] {
+            int x;
+            for (;;) {
+                if (c < 2) {
+                    // Blocking pops only while values are sure to remain.
+                    if (left.fetch_sub(1) <= 0) break;
+                    if (c == 0) dq.pop_front(x);
+                    else dq.pop_back(x);
+                }
+                else {
+                    if (left.load() <= 0) break;
+                    bool ok = c == 2 ? dq.try_pop_front(x) : dq.try_pop_back(x);
+                    if (!ok) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    if (left.fetch_sub(1) <= 0) {
+                        // Claimed by a blocking consumer meanwhile, give it back.
+                        left.fetch_add(1);
+                        dq.push_back(x);
+                        break;
+                    }
+                }
+                taken[x].fetch_add(1);
+            }
+        });
+    }
+    // The size never leaves [0, total], also while pushes and pops race.
+    std::atomic<std::size_t> bad_size(0);
+    std::thread watcher([&] {
+        while (left.load() > 0) {
+            if (dq.size() > std::size_t(total)) bad_size.fetch_add(1);
+        }
+    });
+    for (auto& t: pool) t.join();
+    watcher.join();
+
+    std::size_t wrong = 0;
+    for (auto& t: taken) wrong += t.load() != 1;
+    return wrong + dq.size() + bad_size.load();
+}
+
+signed main()
+{
+    using std::cout;
+    cout << "wrong: " << stress<acc::ConcurrentDeque<int>>(50000) << '\n'; // 0
+    cout << "wrong: " << stress<acc::ConcurrentDeque<int, std::vector<int>,
+                                                     acc::QueueRebuild>>(50000) << '\n'; // 0
+
+    // Single-threaded it is an ordinary deque.
+    acc::ConcurrentDeque<int> dq;
+    for (int i = 0; i < 4; i++) dq.push_back(i), dq.push_front(-i - 1);
+    int x;
+    while (dq.try_pop_front(x)) cout << x << ' ';
+    cout << '\n'; // -4 -3 -2 -1 0 1 2 3
+    cout << dq.try_pop_back(x) << '\n'; // 0
+    return 0;
+}
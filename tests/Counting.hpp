@@ -0,0 +1,41 @@
+// Shared by the tests that count allocations, copies and moves: an
+// allocator that counts its allocations, and an element that counts how
+// often it is copied and moved. Reset the counters before the code checked.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#ifndef _ACC_TESTS_COUNTING
+#define _ACC_TESTS_COUNTING
+
+static std::size_t allocations = 0, copies = 0, moves = 0;
+
+template<typename T>
+struct CountingAlloc : std::allocator<T>
+{
+    template<typename U> struct rebind { typedef CountingAlloc<U> other; };
+
+    CountingAlloc() = default;
+    template<typename U> CountingAlloc(const CountingAlloc<U>&) { }
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return std::allocator<T>::allocate(n);
+    }
+};
+
+struct Counted
+{
+    std::string s;
+
+    Counted(int x): s(std::to_string(x)) { }
+    Counted(const Counted& o): s(o.s) { ++copies; }
+    Counted(Counted&& o) noexcept: s(std::move(o.s)) { ++moves; }
+    Counted& operator=(const Counted& o) { s = o.s; ++copies; return *this; }
+    Counted& operator=(Counted&& o) noexcept { s = std::move(o.s); ++moves; return *this; }
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <list>
+#include <string>
+#include <sstream>
+#include <iterator>
+#define USE_EXTRA_ACC_DEQUE_OPT
+#include "DequeLink.hpp"
+#include "../Counting.hpp"
+
+typedef acc::Deque<Counted, std::vector<Counted, CountingAlloc<Counted>>> Dq;
+
+void print(const Dq& dq)
+{
+    for (const auto& x: dq) std::cout << x.s << ' ';
+    std::cout << '\n';
+}
+
+signed main()
+{
+    using std::cout;
+    std::vector<Counted> v{4, 5, 6};
+    std::list<Counted> l{1, 2, 3};
+    Dq a;
+
+    allocations = copies = 0;
+    a.append_range(v);
+    a.prepend_range(l);
+    print(a); // 1 2 3 4 5 6
+    cout << allocations << ' ' << copies << '\n'; // 2 6
+
+    std::vector<Counted> w{-1, 0};
+    copies = 0;
+    a.prepend_range(std::move(w)); // moves the elements
+    a.insert(a.begin() + 1, l.begin(), l.end());
+    print(a); // -1 1 2 3 0 1 2 3 4 5 6
+    cout << copies << '\n'; // 3
+
+    Dq b;
+    b.append_range(std::vector<Counted>{7, 8});
+    b.push_front(9);
+    allocations = copies = 0;
+    a.append(std::move(b)); // one allocation, no copy
+    print(a); // -1 1 2 3 0 1 2 3 4 5 6 9 7 8
+    cout << allocations << ' ' << copies << ' ' << b.size() << '\n'; // 1 0 0
+
+    allocations = copies = 0;
+    Dq c = a + a; // one allocation
+    cout << c.size() << ' ' << allocations << '\n'; // 28 1
+
+    c += c;
+    cout << c.size() << ' ' << c[28].s << ' ' << c.back().s << '\n'; // 56 -1 8
+
+    // A full target and a source with both blocks in use, the front one
+    // larger than the target: still one allocation for the whole append.
+    Dq t, u;
+    for (int i = 0; i < 8; i++) t.push_back(i);
+    for (int i = 0; i < 10; i++) u.push_front(10 + i);
+    u.push_back(20), u.push_back(21);
+    allocations = 0;
+    t.append(u);
+    cout << t.size() << ' ' << t[8].s << ' ' << t.back().s << ' ' << allocations << '\n';
+    // 20 19 21 1
+    allocations = 0;
+    t.append(std::move(u));
+    cout << t.size() << ' ' << t[20].s << ' ' << allocations << '\n'; // 32 19 1
+
+    // Many small appends keep the geometric growth of the back block.
+    Dq x, one;
+    one.push_back(1);
+    allocations = 0;
+    for (int i = 0; i < 100000; i++) x += one;
+    cout << x.size() << ' ' << (allocations < 40) << '\n'; // 100000 1
+
+    // Input iterators have to be reversed in place.
+    acc::Deque<int> d({5, 6});
+    std::istringstream in("1 2 3 4");
+    d.prepend(std::istream_iterator<int>(in), std::istream_iterator<int>());
+    d.insert(d.begin() + 2, {9, 9});
+    d.insert(d.begin() + 1, 2, 8);
+    cout << d << '\n'; // 1 8 8 2 9 9 3 4 5 6
+    return 0;
+}
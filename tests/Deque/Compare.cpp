@@ -0,0 +1,97 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <unordered_set>
+#include "DequeLink.hpp"
+
+// The deque holding `v` with its first `front` elements in the front block.
+template<typename T>
+acc::Deque<T> make(const std::vector<T>& v, std::size_t front)
+{
+    acc::Deque<T> dq;
+    for (std::size_t i = front; i-- > 0; ) dq.push_front(v[i]);
+    for (std::size_t i = front; i < v.size(); i++) dq.push_back(v[i]);
+    return dq;
+}
+
+template<typename T>
+int sign(const std::vector<T>& a, const std::vector<T>& b)
+{
+    if (std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end())) return -1;
+    return std::lexicographical_compare(b.begin(), b.end(), a.begin(), a.end()) ? 1 : 0;
+}
+
+template<typename T>
+std::size_t check(const std::vector<T>& a, const std::vector<T>& b,
+                  std::size_t lf, std::size_t rf)
+{
+    acc::Deque<T> x = make(a, lf), y = make(b, rf);
+    int s = sign(a, b), t = acc::three_way(x, y);
+    std::size_t bad = (t > 0) - (t < 0) != s;
+    bad += (x == y) != (a == b);
+    bad += (x < y) != (s < 0);
+    bad += (x <= y) != (s <= 0);
+    bad += (x > y) != (s > 0);
+    bad += (x >= y) != (s >= 0);
+    if (a == b) bad += acc::hash_value(x) != acc::hash_value(y);
+    return bad;
+}
+
+// Every split of both operands, equal or differing at the seams and at a
+// few other positions, and with one operand a prefix of the other.
+template<typename T, typename Gen>
+std::size_t all_seams(std::size_t n, std::size_t step, Gen gen)
+{
+    std::mt19937 rng(static_cast<unsigned>(n));
+    std::vector<T> a;
+    for (std::size_t i = 0; i < n; i++) a.push_back(gen(rng() % 5));
+    std::size_t bad = 0;
+    for (std::size_t lf = 0; lf <= n; lf += step) {
+        for (std::size_t rf = 0; rf <= n; rf += step) {
+            bad += check(a, a, lf, rf);
+            std::size_t spots[] = {0, lf, lf - 1, rf, rf - 1, n - 1, rng() % (n + 1)};
+            for (std::size_t k: spots) {
+                if (k >= n) continue;
+                std::vector<T> b = a;
+                b[k] = gen(5 + rng() % 2 * 5);
+                bad += check(a, b, lf, rf);
+                bad += check(b, a, lf, rf);
+            }
+            std::vector<T> p(a.begin(), a.end() - (n != 0));
+            bad += check(a, p, lf, std::min(rf, p.size()));
+            bad += check(p, a, std::min(lf, p.size()), rf);
+        }
+    }
+    return bad;
+}
+
+signed main()
+{
+    using std::cout;
+    auto gi = [](unsigned x) { return int(x) - 5; };
+    auto gd = [](unsigned x) { return double(x) * 0.5 - 2.5; };
+    auto gs = [](unsigned x) { return std::string(1, char('a' + x)); };
+
+    std::size_t bad = 0;
+    for (std::size_t n: {0, 1, 2, 5, 40}) {
+        bad += all_seams<int>(n, 1, gi);
+        bad += all_seams<double>(n, 1, gd);
+        bad += all_seams<std::string>(n, 1, gs);
+    }
+    // Long enough for whole blocks on every piece.
+    bad += all_seams<int>(1000, 37, gi);
+    bad += all_seams<double>(1000, 37, gd);
+    bad += all_seams<long long>(1000, 37, [](unsigned x) { return (long long)(x) << 40; });
+    bad += all_seams<std::string>(300, 29, gs);
+    cout << "mismatches: " << bad << '\n'; // 0
+
+    // Equal contents hash equally, whatever the layout.
+    std::unordered_set<acc::Deque<int>> set;
+    std::vector<int> v{3, 1, 4, 1, 5};
+    for (std::size_t f = 0; f <= v.size(); f++) set.insert(make(v, f));
+    set.insert(make(std::vector<int>{3, 1, 4}, 1));
+    cout << set.size() << '\n'; // 2
+    return 0;
+}
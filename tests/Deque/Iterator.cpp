@@ -0,0 +1,41 @@
+#include <iostream>
+#include <algorithm>
+#include "DequeLink.hpp"
+
+signed main()
+{
+    using std::cout;
+    acc::Deque<int> a;
+    for (int i = 0; i < 4; i++) a.push_front(i);
+    for (int i = 4; i < 8; i++) a.push_back(i);
+    // a is 3 2 1 0 4 5 6 7
+
+    for (auto it = a.begin(); it != a.end(); ++it) cout << *it << ' ';
+    cout << '\n'; // 3 2 1 0 4 5 6 7
+    for (auto it = a.end(); it != a.begin(); ) cout << *--it << ' ';
+    cout << '\n'; // 7 6 5 4 0 1 2 3
+    for (auto it = a.crbegin(); it != a.crend(); ++it) cout << *it << ' ';
+    cout << '\n'; // 7 6 5 4 0 1 2 3
+
+    auto it = a.begin() + 2;
+    cout << *it << ' ' << it[3] << ' ' << *(it += 4) << ' ' << *(it -= 5) << '\n'; // 1 5 6 2
+    cout << (a.end() - a.begin()) << ' ' << (a.cbegin() < a.cend()) << '\n'; // 8 1
+
+    std::sort(a.begin(), a.end());
+    for (int x: a) cout << x << ' ';
+    cout << '\n'; // 0 1 2 3 4 5 6 7
+
+    // Iterators returned by insert point at the first inserted element, and
+    // those returned by erase at the element after the erased ones.
+    it = a.insert(a.begin() + 1, 10);
+    cout << *it << ' ' << it[1] << '\n'; // 10 1
+    it = a.insert(a.begin() + 6, 3, 11);
+    cout << *it << ' ' << it[3] << '\n'; // 11 5
+    it = a.erase(a.begin() + 1);
+    cout << *it << '\n'; // 1
+    it = a.erase(a.begin() + 1, a.begin() + 7);
+    cout << *it << '\n'; // 11
+    for (int x: a) cout << x << ' ';
+    cout << '\n'; // 0 11 5 6 7
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include <iostream>
+#include <string>
+#include "DequeLink.hpp"
+#include "../Counting.hpp"
+
+signed main()
+{
+    using std::cout;
+    acc::Deque<Counted, std::vector<Counted, CountingAlloc<Counted>>> dq;
+    for (int i = 0; i < 1000; i++) dq.emplace_back(i);
+
+    allocations = copies = moves = 0;
+    dq.pop_front(); // rebuild: 500 elements go to the front side.
+    cout << dq.front().s << ' ' << dq.back().s << '\n'; // 1 999
+    cout << "allocations: " << allocations << '\n'; // 1
+    cout << "copies: " << copies << '\n'; // 0
+
+    for (int i = 0; i < 499; i++) dq.pop_front();
+    allocations = copies = 0;
+    dq.pop_front(); // rebuild again, the front buffer is large enough.
+    cout << dq.front().s << ' ' << dq.back().s << '\n'; // 501 999
+    cout << "allocations: " << allocations << '\n'; // 0
+    cout << "copies: " << copies << '\n'; // 0
+
+    while (dq.size() > 1) dq.pop_back();
+    cout << dq.front().s << ' ' << dq.back().s << '\n'; // 501 501
+    dq.pop_back();
+    cout << dq.size() << '\n'; // 0
+    return 0;
+}
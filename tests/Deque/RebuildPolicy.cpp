@@ -0,0 +1,72 @@
+#include <iostream>
+#include "DequeLink.hpp"
+
+static std::size_t moves = 0;
+
+struct Counted
+{
+    int x;
+
+    Counted(int _x): x(_x) { }
+    Counted(const Counted& o) = default;
+    Counted(Counted&& o) noexcept: x(o.x) { ++moves; }
+    Counted& operator=(const Counted& o) = default;
+    Counted& operator=(Counted&& o) noexcept { x = o.x; ++moves; return *this; }
+};
+
+// Keeps a queue of 100 elements for 1000 rounds and counts the moves made
+// by the rebuilds.
+template<typename Policy>
+std::size_t queue_moves()
+{
+    acc::Deque<Counted, std::vector<Counted>, Policy> dq;
+    for (int i = 0; i < 100; i++) dq.emplace_back(i);
+    moves = 0;
+    for (int i = 100; i < 1100; i++) {
+        if (dq.front().x != i - 100) std::cout << "wrong order\n";
+        dq.pop_front();
+        dq.emplace_back(i);
+    }
+    return moves;
+}
+
+signed main()
+{
+    using std::cout;
+    cout << queue_moves<acc::HalfRebuild>() << '\n'; // 2000
+    cout << queue_moves<acc::QueueRebuild>() << '\n'; // 1000
+    cout << queue_moves<acc::AdaptiveRebuild>() << '\n'; // 1000
+
+    acc::Deque<int, std::vector<int>, acc::QueueRebuild> q;
+    for (int i = 0; i < 10; i++) q.push_back(i);
+    q.pop_front(); // everything goes to the front block.
+    cout << q.reversed_front_span().size() << ' ' << q.back_span().size() << '\n'; // 9 0
+    q.pop_back(); // and all of it goes back.
+    cout << q.reversed_front_span().size() << ' ' << q.back_span().size() << '\n'; // 0 8
+
+    acc::Deque<int, std::vector<int>, acc::AdaptiveRebuild> a;
+    for (int i = 0; i < 5; i++) a.push_front(i), a.push_back(i);
+    a.pop_front(), a.pop_front(), a.pop_front(), a.pop_front(), a.pop_front();
+    a.pop_front(); // pushes were balanced, so half goes over.
+    cout << a.reversed_front_span().size() << ' ' << a.back_span().size() << '\n'; // 2 2
+    for (int x: a) cout << x << ' ';
+    cout << '\n'; // 1 2 3 4
+
+    // The counts of AdaptiveRebuild go along with the elements on swap, move
+    // and copy. After 64 pushes at the back, a rebuild towards the front
+    // moves the whole back block; with fresh counts it moves half.
+    typedef acc::Deque<int, std::vector<int>, acc::AdaptiveRebuild> Adaptive;
+    Adaptive f, g, e;
+    for (int i = 0; i < 64; i++) f.push_back(i);
+    while (!f.empty()) f.pop_back();
+    f.assign(10, 7), g.assign(10, 7);
+    f.swap(g);
+    Adaptive h(std::move(g)), c(h);
+    e = c;
+    for (Adaptive* d: {&f, &h, &c, &e}) {
+        d->pop_front();
+        cout << d->reversed_front_span().size() << ' ';
+    }
+    cout << '\n'; // 4 9 9 9
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+#include <vector>
+#include <iterator>
+#include "DequeLink.hpp"
+#include "../../acc/DequeAlgorithm.hpp"
+
+signed main()
+{
+    using std::cout;
+    acc::Deque<int> a;
+    for (int i = 0; i < 5; i++) a.push_front(i);
+    for (int i = 5; i < 10; i++) a.push_back(i);
+    // a is 4 3 2 1 0 5 6 7 8 9
+
+    auto f = a.reversed_front_span(), b = a.back_span();
+    for (int x: f) cout << x << ' ';
+    cout << "| ";
+    for (int x: b) cout << x << ' ';
+    cout << '\n'; // 0 1 2 3 4 | 5 6 7 8 9
+
+    std::vector<int> out;
+    acc::copy(a, std::back_inserter(out));
+    for (int x: out) cout << x << ' ';
+    cout << '\n'; // 4 3 2 1 0 5 6 7 8 9
+
+    cout << acc::find(a, 1) - a.begin() << ' '
+         << acc::find(a, 7) - a.begin() << ' '
+         << acc::find(a, 42) - a.begin() << '\n'; // 3 7 10
+    cout << acc::count(a, 3) << ' ' << acc::accumulate(a, 0) << '\n'; // 1 45
+
+    acc::sort(a);
+    for (int x: a) cout << x << ' ';
+    cout << '\n'; // 0 1 2 3 4 5 6 7 8 9
+    cout << acc::lower_bound(a, 2) - a.begin() << ' '
+         << acc::lower_bound(a, 8) - a.begin() << ' '
+         << acc::lower_bound(a, 10) - a.begin() << '\n'; // 2 8 10
+
+    // Same sequence, every possible front block size.
+    std::size_t mismatches = 0;
+    for (int k = 0; k <= 10; k++) {
+        acc::Deque<int> c;
+        for (int i = k - 1; i >= 0; i--) c.push_front(i);
+        for (int i = k; i < 10; i++) c.push_back(i);
+        if (!acc::equal(a, c) || !acc::equal(c, a)) ++mismatches;
+        c.back() = -1;
+        if (acc::equal(a, c)) ++mismatches;
+    }
+    cout << "mismatches: " << mismatches << '\n'; // 0
+
+    acc::fill(a, 7);
+    cout << acc::count(a, 7) << '\n'; // 10
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/Devector.hpp"
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include "DevectorLink.hpp"
+#include "../Counting.hpp"
+
+signed main()
+{
+    using std::cout;
+    acc::Devector<std::string> dv;
+    std::deque<std::string> ref;
+    std::mt19937 rng(20240601);
+    std::size_t mismatches = 0;
+
+    for (int i = 0; i < 100000; i++) {
+        unsigned op = rng() % 16;
+        std::string s = std::to_string(i);
+        if (op < 5 || ref.empty()) dv.push_back(s), ref.push_back(s);
+        else if (op < 9) dv.push_front(s), ref.push_front(s);
+        else if (op < 11) dv.pop_back(), ref.pop_back();
+        else if (op < 13) dv.pop_front(), ref.pop_front();
+        else if (op < 14) {
+            std::size_t pos = rng() % (ref.size() + 1);
+            dv.insert(dv.begin() + pos, s), ref.insert(ref.begin() + pos, s);
+        }
+        else if (op < 15) {
+            std::size_t pos = rng() % ref.size();
+            dv.erase(dv.begin() + pos), ref.erase(ref.begin() + pos);
+        }
+        else {
+            std::size_t pos = rng() % (ref.size() + 1);
+            dv.insert(dv.begin() + pos, 3, s), ref.insert(ref.begin() + pos, 3, s);
+        }
+        if (dv.size() != ref.size()) ++mismatches;
+        else if (!ref.empty() && (dv.front() != ref.front()
+                                  || dv.back() != ref.back())) ++mismatches;
+    }
+    for (std::size_t i = 0; i < ref.size(); i++) {
+        if (dv[i] != ref[i]) ++mismatches;
+    }
+    cout << "mismatches: " << mismatches << '\n'; // 0
+
+    // The sequence is one span.
+    acc::Devector<int> a({3, 4, 5});
+    a.push_front(2), a.push_front(1), a.push_back(6);
+    a.insert(a.begin() + 3, {10, 11});
+    a.erase(a.begin(), a.begin() + 1);
+    for (int x: a.span()) cout << x << ' ';
+    cout << '\n'; // 2 3 10 11 4 5 6
+    cout << a.data()[2] << ' ' << a.at(6) << '\n'; // 10 6
+    try {
+        a.at(7);
+    }
+    catch (const std::out_of_range&) {
+        cout << "out of range\n"; // out of range
+    }
+
+    // One allocation for a small deque, and pushes at both ends reuse it.
+    acc::Devector<int, CountingAlloc<int>> b;
+    b.reserve_front(8);
+    b.reserve_back(16);
+    cout << b.front_capacity() << ' ' << b.back_capacity() << '\n'; // 8 16
+    allocations = 0;
+    for (int i = 0; i < 8; i++) b.push_front(i), b.push_back(i);
+    cout << "allocations: " << allocations << '\n'; // 0
+
+    // A queue keeps reusing its buffer.
+    acc::Devector<int, CountingAlloc<int>> q;
+    for (int i = 0; i < 100; i++) q.push_back(i);
+    allocations = 0;
+    for (int i = 100; i < 100000; i++) q.push_back(i), q.pop_front();
+    cout << q.front() << ' ' << q.back() << '\n'; // 99900 99999
+    cout << "allocations: " << allocations << '\n'; // 0
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include "MappedVectorLink.hpp"
+
+signed main()
+{
+    using std::cout;
+    std::size_t mismatches = 0;
+
+    // Against std::deque, through growth, rebuilds and shrinking.
+    {
+        acc::MappedDeque<int> dq;
+        std::deque<int> ref;
+        std::mt19937 rng(20240801);
+        for (int i = 0; i < 300000; i++) {
+            unsigned op = rng() % 10;
+            if (op < 4 || ref.empty()) dq.push_back(i), ref.push_back(i);
+            else if (op < 6) dq.push_front(i), ref.push_front(i);
+            else if (op < 7) dq.pop_back(), ref.pop_back();
+            else if (op < 9) dq.pop_front(), ref.pop_front();
+            else {
+                std::size_t pos = rng() % (ref.size() + 1);
+                dq.insert(dq.begin() + pos, i), ref.insert(ref.begin() + pos, i);
+            }
+            if (dq.size() != ref.size()) ++mismatches;
+            if (i % 30000 == 0) {
+                if (!std::equal(ref.begin(), ref.end(), dq.begin())) ++mismatches;
+                dq.shrink_to_fit();
+            }
+        }
+        for (std::size_t i = 0; i < ref.size(); i++) {
+            if (dq[i] != ref[i]) ++mismatches;
+        }
+        acc::MappedDeque<int> copy(dq);
+        if (copy != dq) ++mismatches;
+    }
+    cout << "mismatches: " << mismatches << '\n'; // mismatches: 0
+
+    // A named deque finds its elements again.
+    std::string name = "acc_mapped_test_" + std::to_string(::getpid());
+    {
+        acc::MappedStorage<long long> storage(name);
+        acc::MappedDeque<long long> dq(storage);
+        for (long long i = 0; i < 100000; i++) dq.push_back(i);
+        for (long long i = 1; i <= 5; i++) dq.push_front(-i);
+        dq.pop_front();
+    }
+    {
+        acc::MappedStorage<long long> storage(name);
+        acc::MappedDeque<long long> dq(storage);
+        cout << dq.size() << ' ' << dq.front() << ' ' << dq.back() << '\n'; // 100004 -4 99999
+        dq.pop_front();
+        dq.push_back(100000);
+    }
+    acc::MappedStorage<long long> storage(name);
+    acc::MappedVector<long long> pre(storage), suf(storage);
+    cout << pre.size() << ' ' << suf.size() << ' ' << suf.back() << '\n'; // 3 100001 100000
+    cout << pre.path().substr(pre.path().size() - 2) << '\n'; // .0
+
+    // The files are binary files of acc/BinaryIO.hpp.
+    suf.sync();
+    acc::MappedDequeView<long long> view(suf.path());
+    cout << view.size() << ' ' << view[12345] << '\n'; // 100001 12345
+
+    // Files of another element type are rejected, and closed again: the
+    // lowest free descriptor is the same before and after.
+    int probe = ::dup(0);
+    ::close(probe);
+    try {
+        acc::MappedStorage<int> storage(name);
+        acc::MappedVector<int> wrong(storage);
+    }
+    catch (const std::runtime_error& e) {
+        cout << e.what() << '\n'; // MappedVector: element type differs
+    }
+    int after = ::dup(0);
+    ::close(after);
+    cout << (probe == after) << '\n'; // 1
+    ::unlink(pre.path().c_str());
+    ::unlink(suf.path().c_str());
+
+    acc::MappedVector<double> v{1.5, 2.5};
+    v.insert(v.begin(), 3, 0.5);
+    v.erase(v.begin() + 1);
+    v.push_back(v.front());
+    for (double x: v) cout << x << ' ';
+    cout << '\n'; // 0.5 0.5 1.5 2.5 0.5
+    try {
+        v.at(5);
+    }
+    catch (const std::out_of_range&) {
+        cout << "out_of_range\n"; // out_of_range
+    }
+    return 0;
+}
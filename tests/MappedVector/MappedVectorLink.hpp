@@ -0,0 +1 @@
+#include "../../acc/MappedVector.hpp"
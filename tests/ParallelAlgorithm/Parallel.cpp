@@ -0,0 +1,92 @@
+// g++ -O2 -std=c++17 -pthread Parallel.cpp
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include "ParallelAlgorithmLink.hpp"
+
+// Large enough for several chunks in each block of the deque.
+constexpr int n = 300000;
+
+// x -> a * x + b modulo a prime. Composition is associative but not
+// commutative, so any reordering of the reduction would show.
+struct Affine
+{
+    long long a, b;
+
+    Affine(int x): a(x % 13 + 1), b(x) { }
+    Affine(long long a, long long b): a(a), b(b) { }
+    bool operator!=(const Affine& o) const { return a != o.a || b != o.b; }
+};
+
+Affine compose(Affine f, Affine g)
+{
+    const long long p = 998244353;
+    return Affine(f.a * g.a % p, (g.a * f.b + g.b) % p);
+}
+
+template<typename Seq>
+std::size_t check(acc::ThreadPool& pool, Seq& seq, std::vector<int> ref)
+{
+    std::size_t bad = 0;
+    std::vector<int> out(seq.size());
+    acc::parallel_copy(pool, seq, out.begin());
+    bad += out != ref;
+
+    Affine serial(7);
+    for (int x: ref) serial = compose(serial, x);
+    bad += acc::parallel_reduce(pool, seq, Affine(7), compose) != serial;
+
+    auto it = acc::parallel_find_if(pool, seq, [](int x) { return x % 1000 == 999; });
+    auto rt = std::find_if(ref.begin(), ref.end(), [](int x) { return x % 1000 == 999; });
+    bad += (it - seq.begin()) != (rt - ref.begin());
+    bad += acc::parallel_find_if(pool, seq, [](int x) { return x < 0; }) != seq.end();
+
+    acc::parallel_transform(pool, seq, seq.begin(), [](int x) { return x / 2; });
+    acc::parallel_for_each(pool, seq, [](int& x) { x += 1; });
+    for (int& x: ref) x = x / 2 + 1;
+    acc::parallel_sort(pool, seq, std::greater<int>());
+    std::sort(ref.begin(), ref.end(), std::greater<int>());
+    for (std::size_t i = 0; i < ref.size(); i++) bad += seq[i] != ref[i];
+    return bad;
+}
+
+signed main()
+{
+    using std::cout;
+    std::mt19937 rng(20240701);
+    std::vector<int> ref, front;
+    acc::Deque<int> dq;
+    acc::Vector<int> vec;
+    for (int i = 0; i < n; i++) {
+        int x = int(rng() % 1000000);
+        if (i % 3 == 0) dq.push_front(x), front.push_back(x);
+        else dq.push_back(x), ref.push_back(x);
+    }
+    ref.insert(ref.begin(), front.rbegin(), front.rend());
+    for (int x: ref) vec.push_back(x);
+
+    for (std::size_t threads: {1, 2, 4}) {
+        acc::ThreadPool pool(threads);
+        acc::Deque<int> d(dq);
+        acc::Vector<int> v(vec);
+        cout << check(pool, d, ref) << ' ' << check(pool, v, ref) << '\n'; // 0 0
+    }
+
+    // The default pool, and a job that throws.
+    acc::Deque<std::string> s{"b", "c", "a"};
+    s.push_front("d");
+    acc::parallel_sort(s);
+    for (auto& x: s) cout << x << ' ';
+    cout << '\n'; // a b c d
+    try {
+        acc::ThreadPool pool(2);
+        pool.parallel_for(100, [](std::size_t i) {
+            if (i == 42) throw std::runtime_error("42");
+        });
+    }
+    catch (const std::runtime_error& e) {
+        cout << "caught " << e.what() << '\n'; // caught 42
+    }
+    return 0;
+}
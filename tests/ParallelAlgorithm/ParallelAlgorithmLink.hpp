@@ -0,0 +1 @@
+#include "../../acc/ParallelAlgorithm.hpp"
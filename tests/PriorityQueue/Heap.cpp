@@ -0,0 +1,83 @@
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include "PriorityQueueLink.hpp"
+#include "../../acc/Vector.hpp"
+#include "../../acc/Deque.hpp"
+
+struct Task
+{
+    int priority;
+    std::string name;
+
+    Task(int p, std::string n): priority(p), name(std::move(n)) { }
+    bool operator<(const Task& o) const { return priority < o.priority; }
+};
+
+// Random pushes, pops, pop_pushes and bulk pushes against std::priority_queue.
+template<typename PQ>
+std::size_t check(unsigned seed)
+{
+    PQ pq;
+    std::priority_queue<int> ref;
+    std::mt19937 rng(seed);
+    std::size_t mismatches = 0;
+    for (int i = 0; i < 100000; i++) {
+        unsigned op = rng() % 16;
+        if (op < 7 || ref.empty()) {
+            int v = int(rng() % 1000);
+            pq.push(v), ref.push(v);
+        }
+        else if (op < 12) pq.pop(), ref.pop();
+        else if (op < 15) {
+            int v = int(rng() % 1000);
+            pq.pop_push(v), ref.pop(), ref.push(v);
+        }
+        else {
+            std::vector<int> more(i % 5000 == 0 ? 3000 : rng() % 8);
+            for (int& v: more) v = int(rng() % 1000), ref.push(v);
+            pq.push_range(more);
+        }
+        if (pq.size() != ref.size() || (!ref.empty() && pq.top() != ref.top())) ++mismatches;
+    }
+    while (!ref.empty()) {
+        if (pq.top() != ref.top()) ++mismatches;
+        pq.pop(), ref.pop();
+    }
+    return mismatches + !pq.empty();
+}
+
+signed main()
+{
+    using std::cout;
+    cout << check<acc::PriorityQueue<int>>(1) << '\n'; // 0
+    cout << check<acc::PriorityQueue<int, std::less<int>, std::vector<int>, 2>>(2) << '\n'; // 0
+    cout << check<acc::PriorityQueue<int, std::less<int>, std::vector<int>, 8>>(3) << '\n'; // 0
+    cout << check<acc::PriorityQueue<int, std::less<int>, acc::Vector<int>>>(4) << '\n'; // 0
+    cout << check<acc::PriorityQueue<int, std::less<int>, acc::Deque<int>, 8>>(5) << '\n'; // 0
+
+    // The children of a node share a cache line.
+    acc::PriorityQueue<long long, std::less<long long>,
+        std::vector<long long, acc::CacheAlignedAllocator<long long>>, 8> lines;
+    lines.push(1);
+    cout << (reinterpret_cast<std::uintptr_t>(&lines.top() + 1) % 64) << '\n'; // 0
+
+    acc::PriorityQueue<int, std::greater<int>> least{5, 3, 8, 1};
+    least.pop_push(4);
+    while (!least.empty()) cout << least.top() << ' ', least.pop();
+    cout << '\n'; // 3 4 5 8
+
+    acc::PriorityQueue<int> given(std::less<int>(), std::vector<int, acc::CacheAlignedAllocator<int>>{2, 9, 4});
+    cout << given.size() << ' ' << given.top() << '\n'; // 3 9
+
+    // Elements without a default constructor.
+    acc::PriorityQueue<Task> tasks;
+    tasks.emplace(2, "write");
+    tasks.emplace(5, "review");
+    tasks.push(Task(3, "test"));
+    tasks.pop_push(Task(1, "sleep"));
+    while (!tasks.empty()) cout << tasks.top().name << ' ', tasks.pop();
+    cout << '\n'; // test write sleep
+    return 0;
+}
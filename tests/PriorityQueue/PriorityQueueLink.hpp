@@ -0,0 +1 @@
+#include "../../acc/PriorityQueue.hpp"
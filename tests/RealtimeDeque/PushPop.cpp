@@ -0,0 +1,58 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include "RealtimeDequeLink.hpp"
+
+static std::size_t moves = 0;
+
+struct Counted
+{
+    int x;
+
+    Counted(int x): x(x) { }
+    Counted(const Counted& o): x(o.x) { }
+    Counted(Counted&& o) noexcept: x(o.x) { ++moves; }
+};
+
+signed main()
+{
+    using std::cout;
+    acc::RealtimeDeque<Counted> dq;
+    std::deque<int> ref;
+    std::mt19937 rng(20240501);
+    std::size_t max_moves = 0, mismatches = 0;
+
+    for (int i = 0; i < 200000; i++) {
+        unsigned op = rng() % 8;
+        moves = 0;
+        if (op < 3 || ref.empty()) dq.push_back(i), ref.push_back(i);
+        else if (op < 5) dq.push_front(i), ref.push_front(i);
+        else if (op < 6) dq.pop_back(), ref.pop_back();
+        else dq.pop_front(), ref.pop_front();
+        max_moves = std::max(max_moves, moves);
+        if (dq.size() != ref.size()) ++mismatches;
+        else if (!ref.empty() && (dq.front().x != ref.front()
+                                  || dq.back().x != ref.back())) ++mismatches;
+    }
+    for (std::size_t i = 0; i < ref.size(); i++) {
+        if (dq[i].x != ref[i]) ++mismatches;
+    }
+    cout << "mismatches: " << mismatches << '\n'; // 0
+    cout << "max moves per operation: " << max_moves << '\n'; // 3, 1 pushed + 2 migrated
+
+    // Iterators keep pointing at the same element while a migration runs.
+    acc::RealtimeDeque<int> a({1, 2, 3, 4});
+    auto it = a.begin() + 1;
+    a.push_back(5); // the ring is full, migration starts here.
+    a.push_front(0);
+    cout << *it << ' ' << a.capacity() << '\n'; // 2 8
+    for (auto x: a) cout << x << ' ';
+    cout << '\n'; // 0 1 2 3 4 5
+
+    // Two integers are a count and a value, not an iterator range.
+    acc::RealtimeDeque<int> d(5, 3);
+    cout << d.size() << ' ' << d.back() << ' ';
+    d.assign(4, 2);
+    cout << d.size() << ' ' << d.front() << '\n'; // 5 3 4 2
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/RealtimeDeque.hpp"
\ No newline at end of file
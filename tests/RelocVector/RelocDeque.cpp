@@ -0,0 +1,81 @@
+#include <iostream>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include "RelocVectorLink.hpp"
+
+// Holds a unique_ptr, so it is not trivially copyable, but it may be moved
+// as bytes.
+struct Task
+{
+    std::unique_ptr<int> p;
+
+    Task(int x): p(new int(x)) { }
+    bool operator==(int x) const { return *p == x; }
+};
+
+template<> struct acc::is_trivially_relocatable<Task> : std::true_type { };
+
+template<typename Dq>
+std::size_t check(unsigned seed)
+{
+    Dq dq;
+    std::deque<int> ref;
+    std::mt19937 rng(seed);
+    std::size_t mismatches = 0;
+    for (int i = 0; i < 100000; i++) {
+        unsigned op = rng() % 10;
+        if (op < 3 || ref.empty()) dq.push_back(i), ref.push_back(i);
+        else if (op < 5) dq.push_front(i), ref.push_front(i);
+        else if (op < 6) dq.pop_back(), ref.pop_back();
+        else if (op < 8) dq.pop_front(), ref.pop_front();
+        else if (op < 9) {
+            std::size_t k = rng() % (ref.size() + 1);
+            dq.emplace(dq.begin() + k, i), ref.emplace(ref.begin() + k, i);
+        }
+        else {
+            std::size_t k = rng() % ref.size();
+            dq.erase(dq.begin() + k), ref.erase(ref.begin() + k);
+        }
+        if (dq.size() != ref.size()) ++mismatches;
+    }
+    for (std::size_t i = 0; i < ref.size(); i++) {
+        if (!(dq[i] == ref[i])) ++mismatches;
+    }
+    return mismatches;
+}
+
+struct Str
+{
+    std::string s;
+
+    Str(int x): s(std::to_string(x)) { }
+    bool operator==(int x) const { return s == std::to_string(x); }
+};
+
+signed main()
+{
+    using std::cout;
+    cout << acc::is_trivially_relocatable<double>::value << ' '
+         << acc::is_trivially_relocatable<Task>::value << ' '
+         << acc::is_trivially_relocatable<Str>::value << '\n'; // 1 1 0
+    cout << check<acc::RelocDeque<int>>(1) << '\n'; // 0
+    cout << check<acc::RelocDeque<Task>>(2) << '\n'; // 0
+    cout << check<acc::RelocDeque<Str>>(3) << '\n'; // 0
+    cout << check<acc::RelocDeque<int, acc::QueueRebuild>>(4) << '\n'; // 0
+
+    acc::RelocVector<int> v{1, 2, 3};
+    v.insert(v.begin() + 1, {7, 8});
+    v.erase(v.begin());
+    v.push_back(v.front()); // the argument lives in the buffer that grows.
+    for (int x: v) cout << x << ' ';
+    cout << '\n'; // 7 8 2 3 7
+
+    acc::RelocDeque<int> a{3, 4};
+    a.push_front(2);
+    acc::RelocDeque<int> b(a);
+    b.push_front(1);
+    cout << a.size() << ' ' << b.size() << ' ' << b.front() << '\n'; // 3 4 1
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/RelocVector.hpp"
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include "ReservedVectorLink.hpp"
+
+signed main()
+{
+    using std::cout;
+    std::size_t mismatches = 0;
+
+    // Against std::deque, with elements that own memory.
+    {
+        acc::ReservedDeque<std::string> dq;
+        std::deque<std::string> ref;
+        std::mt19937 rng(20240901);
+        for (int i = 0; i < 200000; i++) {
+            unsigned op = rng() % 10;
+            std::string s = "element " + std::to_string(i);
+            if (op < 4 || ref.empty()) dq.push_back(s), ref.push_back(s);
+            else if (op < 6) dq.push_front(s), ref.push_front(s);
+            else if (op < 7) dq.pop_back(), ref.pop_back();
+            else if (op < 9) dq.pop_front(), ref.pop_front();
+            else {
+                std::size_t pos = rng() % (ref.size() + 1);
+                dq.insert(dq.begin() + pos, s), ref.insert(ref.begin() + pos, s);
+            }
+            if (dq.size() != ref.size()) ++mismatches;
+            if (i % 20000 == 0) {
+                if (!std::equal(ref.begin(), ref.end(), dq.begin())) ++mismatches;
+                dq.shrink_to_fit();
+            }
+        }
+        acc::ReservedDeque<std::string> copy(dq);
+        if (copy != dq || !std::equal(ref.begin(), ref.end(), copy.begin())) ++mismatches;
+    }
+    cout << "mismatches: " << mismatches << '\n'; // mismatches: 0
+
+    // Growth does not move the elements.
+    acc::ReservedVector<long long> v;
+    v.push_back(0);
+    const long long* p = &v[0];
+    for (long long i = 1; i < 3000000; i++) v.push_back(v[i - 1] + 1);
+    cout << (p == v.data()) << ' ' << v.back() << '\n'; // 1 2999999
+
+    // Shrinking gives pages back; the elements stay.
+    v.resize(1000);
+    v.shrink_to_fit();
+    cout << (v.capacity() < 2000) << ' ' << (p == v.data()) << ' ' << v[999] << '\n'; // 1 1 999
+    v.push_back(v.front());
+    cout << v.size() << ' ' << v.back() << '\n'; // 1001 0
+
+    // The reservation is the limit.
+    acc::ReservedVector<int, 1 << 16> small;
+    try {
+        for (int i = 0; i <= (1 << 14); i++) small.push_back(i);
+    }
+    catch (const std::length_error&) {
+        cout << "length_error " << small.size() << '\n'; // length_error 16384
+    }
+
+    acc::ReservedVector<int> w{1, 2, 3};
+    w.insert(w.begin() + 1, {7, 8});
+    w.erase(w.begin());
+    w.insert(w.end(), 2, w[0]);
+    for (int x: w) cout << x << ' ';
+    cout << '\n'; // 7 8 2 3 7 7
+    cout << sizeof(acc::ReservedVector<int>) << '\n'; // 24
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/ReservedVector.hpp"
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <deque>
+#include <random>
+#include <string>
+#include "SmallDequeLink.hpp"
+#include "../Counting.hpp"
+
+template<typename T>
+using Counting = acc::Deque<T, acc::SmallVector<T, 8, CountingAlloc<T>>>;
+
+signed main()
+{
+    using std::cout;
+    acc::SmallDeque<std::string, 4> dq;
+    std::deque<std::string> ref;
+    std::mt19937 rng(20240701);
+    std::size_t mismatches = 0;
+
+    // Stays around the inline capacity, so the blocks keep spilling to the
+    // heap and shrinking back.
+    for (int i = 0; i < 100000; i++) {
+        unsigned op = rng() % 16;
+        std::string s = std::to_string(i);
+        if (op < 4 || ref.empty()) dq.push_back(s), ref.push_back(s);
+        else if (op < 8) dq.push_front(s), ref.push_front(s);
+        else if (op < 10 && ref.size() > 1) dq.pop_back(), ref.pop_back();
+        else if (op < 12 && ref.size() > 1) dq.pop_front(), ref.pop_front();
+        else if (op < 13) {
+            std::size_t pos = rng() % (ref.size() + 1);
+            dq.insert(dq.begin() + pos, s), ref.insert(ref.begin() + pos, s);
+        }
+        else if (op < 14) {
+            std::size_t pos = rng() % ref.size();
+            dq.erase(dq.begin() + pos), ref.erase(ref.begin() + pos);
+        }
+        else if (op < 15) {
+            acc::SmallDeque<std::string, 4> moved(std::move(dq));
+            dq = moved;
+            if (ref.size() > 12) {
+                dq.clear(), ref.clear();
+                dq.shrink_to_fit();
+            }
+        }
+        else {
+            acc::SmallDeque<std::string, 4> other({"a", "b"});
+            other.swap(dq);
+            dq.swap(other);
+        }
+        if (dq.size() != ref.size()) ++mismatches;
+        else if (!ref.empty() && (dq.front() != ref.front()
+                                  || dq.back() != ref.back())) ++mismatches;
+    }
+    for (std::size_t i = 0; i < ref.size(); i++) {
+        if (dq[i] != ref[i]) ++mismatches;
+    }
+    cout << "mismatches: " << mismatches << '\n'; // 0
+
+    // Up to 8 elements at either end need no allocation.
+    allocations = 0;
+    for (int k = 0; k < 1000; k++) {
+        Counting<int> a;
+        for (int i = 0; i < 4; i++) a.push_front(i), a.push_back(i);
+        while (a.size() > 1) a.pop_front();
+        for (int i = 0; i < 7; i++) a.push_front(i);
+        Counting<int> b(std::move(a));
+        b.pop_back();
+    }
+    cout << "allocations: " << allocations << '\n'; // 0
+
+    // Beyond that a block spills to the heap, and iterators work as usual.
+    Counting<int> c;
+    for (int i = 0; i < 10; i++) c.push_back(i);
+    cout << "allocations: " << allocations << '\n'; // 1
+    c.push_front(-1);
+    for (auto it = c.begin() + 1; it < c.end(); it += 3) cout << *it << ' ';
+    cout << '\n'; // 0 3 6 9
+    for (auto it = c.rbegin(); it != c.rend(); ++it) cout << *it << ' ';
+    cout << '\n'; // 9 8 7 6 5 4 3 2 1 0 -1
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/SmallDeque.hpp"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "../../acc/SpscQueue.hpp"
\ No newline at end of file
@@ -0,0 +1,81 @@
+// g++ -O2 -std=c++17 -pthread Stress.cpp (add -fsanitize=thread to check races)
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "SpscQueueLink.hpp"
+
+signed main()
+{
+    using std::cout;
+    const int total = 2000000;
+
+    // The producer pushes one by one or in batches, the consumer pops the
+    // same way, and every value must come out once and in order.
+    acc::SpscQueue<std::unique_ptr<int>> q(100);
+    cout << q.capacity() << '\n'; // 128
+    std::size_t mismatches = 0;
+
+    std::thread producer([&] {
+        std::vector<int> batch;
+        for (int i = 0; i < total; ) {
+            if (i % 7 == 0) {
+                batch.clear();
+                for (int j = i; j < i + 10 && j < total; j++) batch.push_back(j);
+                struct Make
+                {
+                    std::vector<int>::iterator it;
+                    std::unique_ptr<int> operator*() const { return std::unique_ptr<int>(new int(*it)); }
+                    Make& operator++() { ++it; return *this; }
+                };
+                std::size_t n = q.try_push_n(Make{batch.begin()}, batch.size());
+                if (n == 0) std::this_thread::yield();
+                i += int(n);
+            }
+            else if (q.try_push(std::unique_ptr<int>(new int(i)))) i++;
+            else std::this_thread::yield();
+        }
+    });
+
+    std::thread consumer([&] {
+        std::vector<std::unique_ptr<int>> batch(16);
+        for (int expected = 0; expected < total; ) {
+            if (expected % 5 == 0) {
+                std::size_t n = q.try_pop_n(batch.begin(), batch.size());
+                if (n == 0) std::this_thread::yield();
+                for (std::size_t k = 0; k < n; k++) {
+                    if (*batch[k] != expected++) ++mismatches;
+                }
+            }
+            else if (std::unique_ptr<int>* p = q.front()) {
+                if (**p != expected++) ++mismatches;
+                q.pop();
+            }
+            else std::this_thread::yield();
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    cout << "mismatches: " << mismatches << '\n'; // 0
+    cout << q.empty() << '\n'; // 1
+
+    // Full and empty are reported, not waited for.
+    acc::SpscQueue<int> small(4);
+    int x = 0, out[8];
+    for (int i = 0; i < 5; i++) x += small.try_push(i);
+    cout << x << ' ' << small.size() << '\n'; // 4 4
+    cout << small.try_pop_n(out, 8) << ' ' << out[3] << '\n'; // 4 3
+    cout << small.try_pop(x) << '\n'; // 0
+
+    // Elements left in the queue are destroyed with it.
+    std::shared_ptr<int> shared(new int(1));
+    {
+        acc::SpscQueue<std::shared_ptr<int>> left(8);
+        for (int i = 0; i < 6; i++) left.try_push(shared);
+        left.try_pop(shared);
+        cout << shared.use_count() << '\n'; // 6
+    }
+    cout << shared.use_count() << '\n'; // 1
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <iostream>
+#include <numeric>
+#include "VectorLink.hpp"
+
+signed main()
+{
+    using std::cout;
+    acc::Vector<int> a;
+    for (int i = 0; i < 1000; i++) a.push_back(i);
+
+    long long sum = 0;
+    for (int x: a) sum += x;
+    cout << sum << '\n'; // 499500
+
+    // Walk backwards across every block boundary.
+    std::size_t wrong = 0;
+    auto it = a.end();
+    for (int i = 999; i >= 0; i--) {
+        --it;
+        if (*it != i) ++wrong;
+    }
+    cout << "wrong: " << wrong << ' ' << (it == a.begin()) << '\n'; // wrong: 0 1
+
+    // Iterators stay valid while the vector grows.
+    auto mid = a.begin() + 700;
+    for (int i = 1000; i < 5000; i++) a.push_back(i);
+    cout << *mid << ' ' << mid[300] << ' ' << *(a.cend() - 1) << '\n'; // 700 1000 4999
+
+    std::size_t segments = 0;
+    sum = 0;
+    a.for_each_segment([&](const int* p, std::size_t n) {
+        ++segments;
+        sum = std::accumulate(p, p + n, sum);
+    });
+    cout << segments << ' ' << sum << '\n'; // 14 12497500
+
+    std::reverse(a.begin(), a.end());
+    cout << a.front() << ' ' << a.back() << ' ' << *a.rbegin() << '\n'; // 4999 0 0
+    return 0;
+}
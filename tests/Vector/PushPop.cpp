@@ -0,0 +1,51 @@
+#include <iostream>
+#include <string>
+#include "VectorLink.hpp"
+#include "../Counting.hpp"
+
+signed main()
+{
+    using std::cout;
+    acc::Vector<Counted, CountingAlloc<Counted>> a;
+    std::vector<const Counted*> address;
+
+    for (int i = 0; i < 100000; i++) {
+        a.emplace_back(i);
+        address.push_back(&a.back());
+    }
+    std::size_t moved = 0;
+    for (std::size_t i = 0; i < a.size(); i++) {
+        if (&a[i] != address[i] || a[i].s != std::to_string(i)) ++moved;
+    }
+    cout << "relocated elements: " << moved << '\n'; // 0
+    cout << "copies: " << copies << ", moves: " << moves << '\n'; // 0, 0
+    cout << "capacity: " << a.capacity() << '\n'; // 131072
+
+    while (a.size() > 5) a.pop_back();
+    for (const auto& x: a) cout << x.s << ' ';
+    cout << '\n'; // 0 1 2 3 4
+
+    a.shrink_to_fit();
+    cout << "capacity: " << a.capacity() << '\n'; // 8
+
+    allocations = 0;
+    a.reserve(1000);
+    for (int i = 5; i < 1000; i++) a.emplace_back(i);
+    cout << "allocations: " << allocations << '\n'; // 14, 7 blocks and 7 block tables
+    cout << a.front().s << ' ' << a.back().s << '\n'; // 0 999
+
+    acc::Vector<int> b(3, 7);
+    b.resize(5);
+    b.push_back(1);
+    for (auto x: b) cout << x << ' ';
+    cout << '\n'; // 7 7 7 0 0 1
+
+    acc::Vector<int> c({3, 1, 2}), d(c);
+    std::sort(c.begin(), c.end());
+    for (auto x: c) cout << x << ' ';
+    cout << '\n'; // 1 2 3
+    cout << (c == d) << ' ' << (c < d) << '\n'; // 0 1
+    c.clear();
+    cout << c.size() << ' ' << c.empty() << '\n'; // 0 1
+    return 0;
+}
@@ -0,0 +1,57 @@
+// g++ -O2 -std=c++17 -pthread Stress.cpp (add -fsanitize=thread to check races)
+#include <iostream>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "WorkStealingDequeLink.hpp"
+
+signed main()
+{
+    using std::cout;
+    const int total = 300000, thieves = 3;
+
+    // The owner pushes and pops, the thieves steal, and every value must be
+    // taken exactly once. The deque starts small so that it grows while
+    // being stolen from.
+    acc::WorkStealingDeque<int> dq(2);
+    std::vector<std::atomic<int>> taken(total);
+    for (auto& x: taken) x.store(0);
+    std::atomic<bool> done(false);
+    std::atomic<int> stolen(0);
+
+    std::vector<std::thread> pool;
+    for (int k = 0; k < thieves; k++) {
+        pool.emplace_back([&] {
+            int x;
+            while (!done.load()) {
+                if (dq.steal(x)) taken[x].fetch_add(1), stolen.fetch_add(1);
+                else std::this_thread::yield();
+            }
+        });
+    }
+
+    std::mt19937 rng(20240801);
+    int x;
+    for (int i = 0; i < total; i++) {
+        dq.push(i);
+        if (rng() % 3 == 0 && dq.pop(x)) taken[x].fetch_add(1);
+    }
+    while (dq.pop(x)) taken[x].fetch_add(1);
+    done.store(true);
+    for (auto& t: pool) t.join();
+
+    std::size_t wrong = 0;
+    for (auto& t: taken) wrong += t.load() != 1;
+    cout << "wrong: " << wrong << '\n'; // 0
+    cout << dq.empty() << ' ' << (dq.capacity() >= 2) << '\n'; // 1 1
+
+    // The owner works LIFO, the thieves FIFO.
+    acc::WorkStealingDeque<int> a;
+    for (int i = 0; i < 5; i++) a.push(i);
+    a.pop(x);
+    cout << x << ' ';
+    a.steal(x);
+    cout << x << ' ' << a.size() << '\n'; // 4 0 3
+    return 0;
+}
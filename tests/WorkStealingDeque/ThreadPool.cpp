@@ -0,0 +1,100 @@
+// g++ -O2 -std=c++17 -pthread ThreadPool.cpp
+// A minimal work-stealing thread pool: every worker owns a deque, runs its
+// own tasks newest first and steals the oldest task of another worker when
+// it has none. Tasks may spawn more tasks, here to compute a Fibonacci
+// number the naive way.
+#include <iostream>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "WorkStealingDequeLink.hpp"
+
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // The deques are cache-line aligned; keeping them in the pool object,
+    // not each in its own plain `new`, keeps that alignment before C++17.
+    static const unsigned max_threads = 8;
+
+    explicit ThreadPool(unsigned n): n(n)
+    {
+        if (this->n > max_threads) this->n = max_threads;
+        for (unsigned i = 1; i < this->n; i++) workers.emplace_back([this, i] { work(i); });
+    }
+    ~ThreadPool()
+    {
+        stop.store(true);
+        for (auto& t: workers) t.join();
+    }
+
+    // From the thread that created the pool or from a task.
+    void spawn(Task task)
+    {
+        pending.fetch_add(1);
+        queues[self].push(new Task(std::move(task)));
+    }
+
+    // Runs tasks on the calling thread (worker 0) until all are done.
+    void wait()
+    {
+        while (pending.load() != 0) run_one(0);
+    }
+
+private:
+    unsigned n;
+    acc::WorkStealingDeque<Task*> queues[max_threads];
+    std::vector<std::thread> workers;
+    std::atomic<bool> stop{false};
+    std::atomic<long> pending{0};
+    static thread_local unsigned self;
+
+    void work(unsigned i)
+    {
+        self = i;
+        while (!stop.load()) run_one(i);
+    }
+
+    void run_one(unsigned i)
+    {
+        Task* task = nullptr;
+        if (!queues[i].pop(task)) {
+            for (unsigned k = 1; k < n && !task; k++) {
+                queues[(i + k) % n].steal(task);
+            }
+        }
+        if (!task) {
+            std::this_thread::yield();
+            return;
+        }
+        (*task)();
+        delete task;
+        pending.fetch_sub(1);
+    }
+};
+
+thread_local unsigned ThreadPool::self = 0;
+
+void fib(ThreadPool& pool, int n, std::atomic<long>& sum)
+{
+    if (n < 2) {
+        sum.fetch_add(n);
+        return;
+    }
+    pool.spawn([&pool, n, &sum] { fib(pool, n - 1, sum); });
+    pool.spawn([&pool, n, &sum] { fib(pool, n - 2, sum); });
+}
+
+signed main()
+{
+    std::atomic<long> sum(0);
+    {
+        ThreadPool pool(4);
+        pool.spawn([&] { fib(pool, 20, sum); });
+        pool.wait();
+    }
+    std::cout << sum.load() << '\n'; // 6765
+    return 0;
+}
@@ -0,0 +1 @@
+#include "../../acc/WorkStealingDeque.hpp"
\ No newline at end of file